@@ -15,6 +15,10 @@
 #include <linux/kernel.h>   /*for scnprintf*/
 #define __KERNEL_CODE__
 #include "netLinkKernelUtils.h" 
+#include "rt_vrf.h"
+
+/*Room for the TLVs following the text of a reply*/
+#define RT_REPLY_TLVS_LEN   64
 
 /*Global variables of this LKM*/
 static struct sock *nl_sk = NULL;       /*Kernel space Netlink socket ptr*/
@@ -29,6 +33,183 @@ static struct sock *nl_sk = NULL;       /*Kernel space Netlink socket ptr*/
  * provide setters/getters for this purpose. We will use them as 
  * we would need along the way*/
 
+/*Copies the text TLV of type into buf, NUL terminated. 0 if absent*/
+static int
+rt_tlv_get_str(char *tlvs, int len, int type, char *buf, int buf_len){
+
+    struct rtattr *tlv = TLV_FIND(tlvs, len, type);
+    int str_len;
+
+    if(!tlv)
+        return 0;
+
+    str_len = min_t(int, RTA_PAYLOAD(tlv), buf_len - 1);
+    memcpy(buf, RTA_DATA(tlv), str_len);
+    buf[str_len] = '\0';
+    return 1;
+}
+
+static int
+rt_tlv_get_u32(char *tlvs, int len, int type, uint32_t *val){
+
+    struct rtattr *tlv = TLV_FIND(tlvs, len, type);
+
+    if(!tlv || RTA_PAYLOAD(tlv) < sizeof(uint32_t))
+        return 0;
+
+    memcpy(val, RTA_DATA(tlv), sizeof(uint32_t));
+    return 1;
+}
+
+static void
+rt_netlink_route_msg(struct nlmsghdr *nlh, char *tlvs, int len,
+                     char *reply, int reply_len){
+
+    uint32_t id, mask;
+    char dest[RT_IP_ADDR_STRLEN], gw[RT_IP_ADDR_STRLEN], oif[IFNAMSIZ];
+    rt_vrf_t *vrf;
+    rt_bool_t rc = RT_FALSE;
+
+    gw[0] = oif[0] = '\0';
+
+    if(!rt_tlv_get_u32(tlvs, len, NETLINK_TLV_RT_ID, &id) ||
+       !rt_tlv_get_str(tlvs, len, NETLINK_TLV_RT_DEST, dest, sizeof(dest)) ||
+       !rt_tlv_get_u32(tlvs, len, NETLINK_TLV_RT_MASK, &mask) || mask > RT_IPV6_MAX_MASK){
+        snprintf(reply, reply_len, "Malformed %s msg", netlink_get_msg_type(nlh->nlmsg_type));
+        return;
+    }
+
+    /*Not needed to delete a route*/
+    rt_tlv_get_str(tlvs, len, NETLINK_TLV_RT_GW, gw, sizeof(gw));
+    rt_tlv_get_str(tlvs, len, NETLINK_TLV_RT_OIF, oif, sizeof(oif));
+
+    vrf = rt_vrf_get(id);
+
+    if(!vrf){
+        snprintf(reply, reply_len, "No routing table with id %u", id);
+        return;
+    }
+
+    /*Serialized by the lock of this table only*/
+    switch(nlh->nlmsg_type){
+        case NLMSG_RT_ROUTE_ADD:
+            rc = rt_add_new_rt_entry(&vrf->rt_table, dest, mask, gw, oif);
+            break;
+        case NLMSG_RT_ROUTE_DELETE:
+            rc = rt_delete_rt_entry(&vrf->rt_table, dest, mask);
+            break;
+        case NLMSG_RT_ROUTE_UPDATE:
+            rc = rt_update_rt_entry(&vrf->rt_table, dest, mask, gw, oif);
+            break;
+    }
+
+    snprintf(reply, reply_len, "%s %s/%u in routing table %s (id %u) %s",
+        netlink_get_msg_type(nlh->nlmsg_type), dest, mask, vrf->name, id,
+        rc ? "done" : "failed");
+
+    rt_vrf_put(vrf);
+}
+
+/*Moves a table to another engine, its lookups going on meanwhile*/
+static void
+rt_netlink_engine_msg(char *tlvs, int len, char *reply, int reply_len){
+
+    uint32_t id, engine;
+    rt_vrf_t *vrf;
+
+    if(!rt_tlv_get_u32(tlvs, len, NETLINK_TLV_RT_ID, &id) ||
+       !rt_tlv_get_u32(tlvs, len, NETLINK_TLV_RT_ENGINE, &engine)){
+        snprintf(reply, reply_len, "Malformed NLMSG_RT_SET_ENGINE msg");
+        return;
+    }
+
+    vrf = rt_vrf_get(id);
+
+    if(!vrf){
+        snprintf(reply, reply_len, "No routing table with id %u", id);
+        return;
+    }
+
+    if(rt_table_set_engine(&vrf->rt_table, engine, 0))
+        snprintf(reply, reply_len, "Routing table %s (id %u) uses engine %s",
+            vrf->name, id, rt_engine_name(engine));
+    else
+        snprintf(reply, reply_len, "Routing table %s (id %u) could not move to engine %s",
+            vrf->name, id, rt_engine_name(engine));
+
+    rt_vrf_put(vrf);
+}
+
+/* Carries out the msg, the text of the reply tells what it did. len is
+ * the number of bytes received, the msg may claim more. Returns the
+ * length of the TLVs it put in reply_tlvs, RT_REPLY_TLVS_LEN bytes*/
+static int
+rt_netlink_process_msg(struct nlmsghdr *nlh, int len, char *reply, int reply_len,
+                       char *reply_tlvs){
+
+    char *tlvs = nlmsg_data(nlh);
+    char name[RT_VRF_NAME_LEN];
+    uint32_t id, engine;
+    int rc, tlvs_len = 0;
+
+    len = min_t(int, len, nlh->nlmsg_len) - NLMSG_HDRLEN;
+
+    switch(nlh->nlmsg_type){
+
+        case NLMSG_RT_NEW_CREATE:
+            if(!rt_tlv_get_str(tlvs, len, NETLINK_TLV_RT_CREATE, name, sizeof(name))){
+                snprintf(reply, reply_len, "Malformed NLMSG_RT_NEW_CREATE msg");
+                break;
+            }
+
+            engine = RT_ENGINE_LIST;
+            rt_tlv_get_u32(tlvs, len, NETLINK_TLV_RT_ENGINE, &engine);
+
+            rc = rt_vrf_create(name, engine, &id);
+
+            if(!rc)
+                snprintf(reply, reply_len, "Routing table %s created, id %u, engine %s",
+                    name, id, rt_engine_name(engine));
+            else if(rc == -EEXIST)
+                snprintf(reply, reply_len, "Routing table %s already exists, id %u", name, id);
+            else
+                snprintf(reply, reply_len, "Routing table %s creation failed, error %d", name, rc);
+
+            /*The id the other msgs are to carry*/
+            if(!rc || rc == -EEXIST)
+                tlvs_len = TLV_ADD(reply_tlvs, NETLINK_TLV_RT_ID, sizeof(id), (char *)&id);
+            break;
+
+        case NLMSG_RT_DELETE:
+            if(!rt_tlv_get_u32(tlvs, len, NETLINK_TLV_RT_ID, &id)){
+                snprintf(reply, reply_len, "Malformed NLMSG_RT_DELETE msg");
+                break;
+            }
+
+            if(rt_vrf_delete(id))
+                snprintf(reply, reply_len, "No routing table with id %u", id);
+            else
+                snprintf(reply, reply_len, "Routing table with id %u deleted", id);
+            break;
+
+        case NLMSG_RT_ROUTE_ADD:
+        case NLMSG_RT_ROUTE_DELETE:
+        case NLMSG_RT_ROUTE_UPDATE:
+            rt_netlink_route_msg(nlh, tlvs, len, reply, reply_len);
+            break;
+
+        case NLMSG_RT_SET_ENGINE:
+            rt_netlink_engine_msg(tlvs, len, reply, reply_len);
+            break;
+
+        default:
+            /*defined in linux/kernel.h */
+            snprintf(reply, reply_len, 
+                "Msg from Process %d has been processed by kernel", nlh->nlmsg_pid);
+    }
+    return tlvs_len;
+}
+
 /* When the Data/msg comes over netlink socket from userspace, kernel
  * packages the data in sk_buff data structures and invokes the below
  * function with pointer to that skb*/
@@ -39,9 +220,10 @@ static void netlink_recv_msg_fn(struct sk_buff *skb_in){
     char *user_space_data;
     int user_space_data_len;
     struct sk_buff *skb_out;
-    char kernel_reply[256];
+    char kernel_reply[NETLINK_REPLY_TEXT_LEN];
+    char reply_tlvs[RT_REPLY_TLVS_LEN];
     int user_space_process_port_id;
-    int res;
+    int res, reply_tlvs_len;
 
     printk(KERN_INFO "%s() invoked", __FUNCTION__);
 
@@ -62,14 +244,13 @@ static void netlink_recv_msg_fn(struct sk_buff *skb_in){
             __FUNCTION__, __LINE__, user_space_data, user_space_data_len, nlh_recv->nlmsg_len);
 
 
+    memset(kernel_reply, 0 , sizeof(kernel_reply));
+    reply_tlvs_len = rt_netlink_process_msg(nlh_recv, user_space_data_len,
+                        kernel_reply, sizeof(kernel_reply), reply_tlvs);
+
     if(nlh_recv->nlmsg_flags & NLM_F_ACK){
 
         /*Sending reply back to user space process*/
-        memset(kernel_reply, 0 , sizeof(kernel_reply));
-
-        /*defined in linux/kernel.h */
-        snprintf(kernel_reply, sizeof(kernel_reply), 
-                "Msg from Process %d has been processed by kernel", nlh_recv->nlmsg_pid);
 
         /*Get a new sk_buff with empty Netlink hdr already appended before payload space
          * i.e skb_out->data will be pointer to below msg : 
@@ -80,19 +261,20 @@ static void netlink_recv_msg_fn(struct sk_buff *skb_in){
          *
          * */
 
-        skb_out = nlmsg_new(sizeof(kernel_reply), 0/*Related to memory allocation, skip...*/);
+        skb_out = nlmsg_new(sizeof(kernel_reply) + reply_tlvs_len, 0/*Related to memory allocation, skip...*/);
 
         /*Add a TLV*/ 
         nlh_reply = nlmsg_put(skb_out,
                 0,                  /*Sender is kernel, hence, port-id = 0*/
                 nlh_recv->nlmsg_seq,        /*reply with same Sequence no*/
                 NLMSG_DONE,                 /*Metlink Msg type*/
-                sizeof(kernel_reply),       /*Payload size*/
+                sizeof(kernel_reply) + reply_tlvs_len,  /*Payload size, text then TLVs*/
                 0);                         /*Flags*/
 
         /* copy the paylod now. In userspace, use NLMSG_DATA, in kernel space
          * use nlmsg_data*/
-        strncpy(nlmsg_data(nlh_reply), kernel_reply, sizeof(kernel_reply));
+        memcpy(nlmsg_data(nlh_reply), kernel_reply, sizeof(kernel_reply));
+        memcpy((char *)nlmsg_data(nlh_reply) + sizeof(kernel_reply), reply_tlvs, reply_tlvs_len);
 
         /*Finaly Send the  msg to user space space process*/
         res = nlmsg_unicast(nl_sk, skb_out, user_space_process_port_id);
@@ -149,6 +331,8 @@ static void __exit NetlinkProject_exit(void) {
     /*Release any kernel resources held by this module in this fn*/
     netlink_kernel_release(nl_sk);
     nl_sk = NULL;
+    /*No msg can come anymore*/
+    rt_vrf_destroy_all();
 }
 
 
@@ -0,0 +1,8 @@
+RT_OBJS="rt_user.o rt_table.o rt_trie.o rt_dir24_8.o rt_tbm.o rt_nexthop.o rt_iface.o rt_cold.o rt_pool.o rt_fib.o rt_cache.o rt_small.o rt_interval.o rt_journal.o rt_ortc.o rt_counters.o rt_sink.o rt_epoch.o gluethread/glthread.o"
+rm -f $RT_OBJS *exe
+for src in $RT_OBJS; do
+gcc -g -O2 -c ${src%.o}.c -o $src
+done
+gcc -g -O2 rt_bench_mt.c $RT_OBJS -o rt_bench_mt.exe -lpthread
+gcc -g -O2 rt_bench.c $RT_OBJS -o rt_bench.exe -lpthread -lm
+gcc -g -O2 rt_test.c $RT_OBJS -o rt_test.exe -lpthread
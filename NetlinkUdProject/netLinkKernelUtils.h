@@ -32,11 +32,15 @@
 #define __NL_COMMON__
 
 #include <linux/netlink.h>
+#include <linux/rtnetlink.h>    /*struct rtattr, RTA_XXX macros*/
 
 /* maximum payload size in Bytes exchanged between kernel and userspace
  * in either directions*/
 #define MAX_PAYLOAD     1024
 #define RT_NAME_LEN     32
+/* Replies of the kernel are NETLINK_REPLY_TEXT_LEN bytes of NUL
+ * terminated text telling what was done, followed by TLVs*/
+#define NETLINK_REPLY_TEXT_LEN  256
 #define TLV_OVERHEAD    (RTA_ALIGN(sizeof(struct rtattr)))
 
 
@@ -45,20 +49,49 @@ TLV_ADD(char *tlv_start, int type, int len, char *val)
 {
     
     struct rtattr *tlv_start_ptr = (struct rtattr *)tlv_start;
-    tlv_start_ptr->rta_len = RTA_ALIGN(len);
+    tlv_start_ptr->rta_len = RTA_LENGTH(len);
     tlv_start_ptr->rta_type = (__u16)type;
     memset(RTA_DATA(tlv_start_ptr), 0, RTA_ALIGN(len));
     memcpy(RTA_DATA(tlv_start_ptr), val, len);
     return TLV_OVERHEAD + RTA_ALIGN(len); /*Alternatively : return RTA_SPACE(len)*/
 }
 
+/*Returns the TLV of type among the len bytes of TLVs at tlv_start, NULL if absent*/
+static inline struct rtattr *
+TLV_FIND(char *tlv_start, int len, int type)
+{
+    struct rtattr *tlv = (struct rtattr *)tlv_start;
+
+    for(; RTA_OK(tlv, len); tlv = RTA_NEXT(tlv, len)){
+        if(tlv->rta_type == type)
+            return tlv;
+    }
+    return NULL;
+}
+
 /*User defined NL MSG TYPES, should be > 16 */
 #define NLMSG_GREET     20
 #define NLMSG_RT_NEW_CREATE   21
+#define NLMSG_RT_DELETE       22
+#define NLMSG_RT_ROUTE_ADD    23
+#define NLMSG_RT_ROUTE_DELETE 24
+#define NLMSG_RT_ROUTE_UPDATE 25
+#define NLMSG_RT_SET_ENGINE   26
 
 
 /*TLVs Code Points*/
-#define NETLINK_TLV_RT_CREATE   1
+#define NETLINK_TLV_RT_CREATE   1   /*Name of the table to create*/
+/* The reply to NLMSG_RT_NEW_CREATE carries the numeric id of the table,
+ * new or already there, in this TLV, which the other msgs carry in turn*/
+#define NETLINK_TLV_RT_ID       2   /*uint32_t*/
+#define NETLINK_TLV_RT_DEST     3   /*Text address*/
+#define NETLINK_TLV_RT_MASK     4   /*uint32_t*/
+#define NETLINK_TLV_RT_GW       5   /*Text address*/
+#define NETLINK_TLV_RT_OIF      6   /*Interface name*/
+/* Engine of the IPV4 lookups of a table, a rt_engine_t of rt.h : 0 list,
+ * 1 trie, 2 tree bitmap, 3 DIR-24-8, 4 interval. Optional in NLMSG_RT_NEW_CREATE,
+ * NLMSG_RT_SET_ENGINE moves the table given by id to it*/
+#define NETLINK_TLV_RT_ENGINE   7   /*uint32_t*/
 
 
 
@@ -89,6 +122,16 @@ netlink_get_msg_type(__u16 nlmsg_type){
             return "NLMSG_GREET";
         case NLMSG_RT_NEW_CREATE:
             return "NLMSG_RT_NEW_CREATE";
+        case NLMSG_RT_DELETE:
+            return "NLMSG_RT_DELETE";
+        case NLMSG_RT_ROUTE_ADD:
+            return "NLMSG_RT_ROUTE_ADD";
+        case NLMSG_RT_ROUTE_DELETE:
+            return "NLMSG_RT_ROUTE_DELETE";
+        case NLMSG_RT_ROUTE_UPDATE:
+            return "NLMSG_RT_ROUTE_UPDATE";
+        case NLMSG_RT_SET_ENGINE:
+            return "NLMSG_RT_SET_ENGINE";
         default:
             return "NLMSG_UNKNOWN";
     }
@@ -32,28 +32,158 @@
 #define __RT__
 
 #include "gluethread/glthread.h"
-
-typedef enum rt_bool_{
-
-    RT_FALSE,
-    RT_TRUE
-} rt_bool_t;
+#include "rt_common.h"
+#include "rt_trie.h"
+#include "rt_dir24_8.h"
+#include "rt_tbm.h"
+#include "rt_nexthop.h"
+#include "rt_cold.h"
+#include "rt_pool.h"
+#include "rt_fib.h"
+#include "rt_ortc.h"
+#include "rt_small.h"
+#include "rt_interval.h"
+#include "rt_journal.h"
+#include "rt_counters.h"
+#include "rt_sink.h"
+#ifdef __KERNEL__
+#include <linux/rhashtable.h>
+#include <linux/mutex.h>
+#include <linux/workqueue.h>
+#else
+#include <pthread.h>
+#endif
 
 typedef struct rt_entry_{
 
-    char dest_ip[16];
-    char mask;
-    char gw_ip[16];
-    char oif[32];
+    /*Fields read by lookups, they come first and are all binary*/
+    uint8_t dest_addr[RT_IPV6_ADDR_LEN];    /*Masked, network byte order*/
+    uint8_t mask;
+    uint8_t family;         /*AF_INET or AF_INET6*/
+    /*Outgoing interface, 0 if it does not exist. Of the first path of a
+     * multipath route, see rt_entry_nexthop()*/
+    uint32_t ifindex;
+    uint32_t nh_id;         /*Next hop or group, in rt_table_t.nexthops*/
+    /*Control plane fields*/
+    uint32_t cold_id;       /*Text form of the route, in rt_table_t.cold*/
+    /*Next hop index of this route in rt_table_t.dir24_8*/
+    uint32_t dir24_8_nh_idx;
+#ifdef __KERNEL__
+    struct rhash_head rt_hash_node;
+#else
+    struct rt_entry_ *hash_next;
+#endif
+#ifdef __KERNEL__
+    union{
+        glthread_t rt_entry_glue;
+        /*Once off the list, to free the entry after a grace period*/
+        struct rcu_head rcu;
+    };
+#else
     glthread_t rt_entry_glue;
+#endif
 } rt_entry_t;
 
+/*A route is exactly one cache line on 64 bit machines, keep it so*/
+_Static_assert(sizeof(rt_entry_t) <= 64, "rt_entry_t exceeds a cache line");
+
 GLTHREAD_TO_STRUCT(rt_entry_glue_to_rt_entry, 
     rt_entry_t, rt_entry_glue);
 
+/* Exact match index of the routes, one hash table per prefix length
+ * keyed on dest_addr. Kernel uses resizable rhashtables, user space a
+ * chained hash table which doubles/halves with the number of entries*/
+#ifdef __KERNEL__
+typedef struct rhashtable rt_prefix_hash_t;
+#else
+typedef struct rt_prefix_hash_{
+
+    rt_entry_t **buckets;
+    uint32_t n_buckets;     /*Power of 2*/
+    uint32_t n_entries;
+} rt_prefix_hash_t;
+#endif
+
+typedef struct rt_prefix_index_{
+
+    /*Bit n is set if some /n prefix is present, the hash table of a
+     * prefix length is created when the first such prefix is added*/
+    uint64_t len_bmp4;
+    uint64_t len_bmp6[(RT_IPV6_MAX_MASK / 64) + 1];
+    rt_prefix_hash_t *hash4[RT_IPV4_MAX_MASK + 1];
+    rt_prefix_hash_t *hash6[RT_IPV6_MAX_MASK + 1];
+} rt_prefix_index_t;
+
+/* The APIs below which modify or dump the table are serialized by the
+ * table mutex and may sleep. The lookups take no lock, they are to be
+ * called between rt_read_lock() and rt_read_unlock(), from softirq as
+ * well in the kernel, and the returned entry may be used until
+ * rt_read_unlock(). Routes are freed once the lookups in flight are
+ * over, and while a route is updated a lookup reads either the old or
+ * the new value of each of its fields.
+ * In the kernel these are RCU read side sections, in user space any
+ * number of threads may do lookups, with epoch based reclamation*/
+#ifdef __KERNEL__
+#define rt_read_lock()      rcu_read_lock()
+#define rt_read_unlock()    rcu_read_unlock()
+#else
+#define rt_read_lock()      rt_epoch_read_lock()
+#define rt_read_unlock()    rt_epoch_read_unlock()
+#endif
+
+struct rt_engine_ops_;
+
 typedef struct rt_table_{
 
+#ifdef __KERNEL__
+    struct mutex lock;
+#else
+    pthread_mutex_t lock;
+    /*Memory unlinked from the table waiting for the readers*/
+    rt_epoch_limbo_t limbo;
+#endif
     glthread_t head;
+    /*rt_entry_t objects of this table are allocated from here*/
+    rt_pool_t entry_pool;
+    rt_nexthop_table_t nexthops;
+    rt_cold_table_t cold;
+    rt_prefix_index_t prefix_index;
+    /*Index of the entries in the list above for longest prefix match*/
+    rt_trie_t trie;
+    /*IPV6 routes are indexed by a tree bitmap*/
+    rt_tbm_t tbm6;
+    /*Scanned instead of the trie by the list engine while there are at
+     * most RT_SMALL_MAX / 2 IPV4 routes, until there are more than
+     * RT_SMALL_MAX. NULL otherwise*/
+    rt_small_t *small4;
+    /*Compiled representations of the IPV4 routes, NULL unless they are
+     * the engine of the table*/
+    rt_dir24_8_t *dir24_8;
+    rt_tbm_t *tbm4;
+    /*NULL from a change of the IPV4 routes until the end of the call*/
+    rt_interval_t *interval4;
+    /*Engine of the IPV4 lookups, see rt_table_set_engine()*/
+    const struct rt_engine_ops_ *engine;
+    /*Bumped by every change of the routes, once the change is visible
+     * to the lookups. Caches of lookup results are tagged with it*/
+    uint64_t generation;
+    /*Last changes of the routes by generation, NULL if not enabled*/
+    rt_journal_t *journal;
+    /*Hits and bytes of the routes, NULL if not enabled*/
+    rt_counters_t *counters;
+    /*Compiled snapshot of the routes, NULL if not enabled*/
+    rt_fib_t *fib;
+    uint32_t fib_debounce_ms;   /*0 if recompiled on demand only*/
+    rt_bool_t fib_compress;     /*See rt_table_compress_fib()*/
+#ifdef __KERNEL__
+    struct delayed_work fib_work;
+#else
+    /*Recompiles the snapshot when fib_dirty is signalled on fib_cond*/
+    pthread_t fib_thread;
+    pthread_cond_t fib_cond;
+    rt_bool_t fib_dirty;
+    rt_bool_t fib_thread_running;
+#endif
 } rt_table_t;
 
 void
@@ -72,13 +202,316 @@ rt_update_rt_entry(rt_table_t *rt_table,
     char *dest_ip, char mask, 
     char *new_gw_ip, char *new_oif);
 
+/*A path of a multipath route*/
+typedef struct rt_path_{
+
+    char *gw_ip;
+    char *oif;
+    uint32_t weight;    /*Share of the flows relative to the other paths*/
+} rt_path_t;
+
+/* Same as above for routes over up to RT_NEXTHOP_MAX_PATHS paths, the
+ * flows being spread over them by weight. Routes with the same paths
+ * share one next hop group. Updating the paths of a route moves only
+ * the flows of the paths which lost share*/
+rt_bool_t
+rt_add_multipath_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask, const rt_path_t *paths, uint32_t n_paths);
+
+rt_bool_t
+rt_update_multipath_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask, const rt_path_t *paths, uint32_t n_paths);
+
+/*A route of rt_bulk_load(), as passed to rt_add_new_rt_entry()*/
+typedef struct rt_bulk_entry_{
+
+    char *dest_ip;
+    char mask;
+    char *gw_ip;
+    char *oif;
+} rt_bulk_entry_t;
+
+/* Adds n routes at once, skipping the invalid and duplicate ones as
+ * rt_add_new_rt_entry() would, and returns the number added. The
+ * prefixes are sorted unless they already are, the routes allocated
+ * in one go and the trie of an empty table built bottom up in a single
+ * pass, much faster than adding the routes one by one*/
+uint32_t
+rt_bulk_load(rt_table_t *rt_table, const rt_bulk_entry_t *routes, uint32_t n);
+
+/* Flushes all the routes in constant time : the lookup structures are
+ * swapped for empty ones, the enabled engines included, and the old
+ * ones freed in the background once the lookups in flight are done*/
 void
 rt_clear_rt_table(rt_table_t *rt_table);
 
+/* Flushes the table as above and releases what it holds, the table has
+ * to be initialized again before use*/
 void
 rt_free_rt_table(rt_table_t *rt_table);
 
+/* Waits until the tables flushed so far are freed, to be called before
+ * the module is unloaded or the program exits*/
+void
+rt_reclaim_barrier(void);
+
 void
 rt_dump_rt_table(rt_table_t *rt_table);
 
+typedef enum{
+
+    /*rt_dump_header_t then a rt_dump_rec_t per path, in host byte order*/
+    RT_DUMP_BINARY,
+    /*A header line then a line per path*/
+    RT_DUMP_CSV,
+    /*An array of routes, each with its array of paths*/
+    RT_DUMP_JSON
+} rt_dump_format_t;
+
+#define RT_DUMP_MAGIC       0x50445452      /*"RTDP"*/
+#define RT_DUMP_VERSION     1
+
+typedef struct rt_dump_header_{
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t rec_size;      /*sizeof(rt_dump_rec_t)*/
+    uint64_t generation;    /*Of the table dumped*/
+} rt_dump_header_t;
+
+typedef struct rt_dump_rec_{
+
+    uint8_t dest_addr[RT_IPV6_ADDR_LEN];    /*Network byte order*/
+    uint8_t gw_addr[RT_IPV6_ADDR_LEN];      /*All zero if none*/
+    char oif[RT_IF_NAME_LEN];
+    /*Of the route, 0 unless the counters are enabled or path is not 0*/
+    uint64_t hits;
+    uint64_t bytes;
+    uint32_t ifindex;
+    uint32_t weight;
+    uint8_t mask;
+    uint8_t family;
+    uint8_t gw_family;
+    uint8_t path;           /*Of the route, 0 starts a new one*/
+    uint8_t n_paths;
+    uint8_t pad[3];
+} rt_dump_rec_t;
+
+/* Dumps the routes into sink in the given format, the whole table
+ * taking a few large writes rather than a printk()/printf() per route.
+ * The counters of a multipath route come with its first path. The table
+ * stays locked until the last chunk is written, so the writers wait for
+ * a slow sink. RT_FALSE if write_fn of the sink failed*/
+rt_bool_t
+rt_dump_rt_table_to_sink(rt_table_t *rt_table, rt_sink_t *sink,
+                         rt_dump_format_t format);
+
+/* Compiles the routes into an immutable snapshot (see rt_fib.h) which
+ * rt_table_fib() returns. With debounce_ms, the snapshot is compiled
+ * again at most debounce_ms after the routes change, so a burst of
+ * changes costs a single compilation, otherwise only on
+ * rt_table_fib_compile()*/
+rt_bool_t
+rt_table_enable_fib(rt_table_t *rt_table, uint32_t debounce_ms);
+
+void
+rt_table_disable_fib(rt_table_t *rt_table);
+
+/* Compiles the snapshots from a minimal set of prefixes forwarding as
+ * the routes do (see rt_ortc.h), recompiling the current one if any.
+ * More specifics via the same next hop as their covering route fold
+ * into it, making the snapshot smaller. Its results then tell only the
+ * gateway and interface of an address, the prefix being the one of the
+ * compressed set. Each compilation compresses the routes again, with
+ * debounce_ms a burst of updates costs a single pass*/
+rt_bool_t
+rt_table_compress_fib(rt_table_t *rt_table, rt_bool_t compress);
+
+/*Recompiles the snapshot now, RT_FALSE if not enabled or out of memory*/
+rt_bool_t
+rt_table_fib_compile(rt_table_t *rt_table);
+
+/* Current snapshot of the table, NULL if not enabled. It stays valid
+ * until rt_read_unlock(), lookups in it need no other synchronization*/
+static inline rt_fib_t *
+rt_table_fib(rt_table_t *rt_table){
+
+    return RT_DEREF(rt_table->fib);
+}
+
+#ifndef __KERNEL__
+/* Saves a snapshot of the routes to path, which rt_fib_map() maps back
+ * ready for lookups, say after a restart, without reinserting them*/
+rt_bool_t
+rt_table_save(rt_table_t *rt_table, const char *path);
+#endif
+
+/* Records the last n_changes changes of the routes, or more, in a ring
+ * read by rt_table_changes_since(). It costs one record per route
+ * added, deleted or updated*/
+rt_bool_t
+rt_table_enable_journal(rt_table_t *rt_table, uint32_t n_changes);
+
+void
+rt_table_disable_journal(rt_table_t *rt_table);
+
+/*Called with the table locked, it must not call the APIs above*/
+typedef void (*rt_change_fn_t)(const rt_journal_rec_t *change, void *arg);
+
+/* Calls fn on each change of the routes after generation, oldest first,
+ * and sets to_generation to the generation of the table they bring the
+ * caller to, to pass next time. Starting from generation 0 replays all
+ * the changes since the journal was enabled at generation 0.
+ * RT_FALSE if the journal is not enabled or has lost some of these
+ * changes : the caller has to walk the whole table again, then go on
+ * from to_generation. The changes it may have seen in that walk come
+ * again, applying them twice is harmless since the records carry the
+ * state of the route after the change*/
+rt_bool_t
+rt_table_changes_since(rt_table_t *rt_table, uint64_t generation,
+                       rt_change_fn_t fn, void *arg, uint64_t *to_generation);
+
+/* Counts the hits and bytes of each route in per CPU counters, which
+ * rt_route_counters() and the dumps sum up. They take 16 bytes per
+ * route and CPU, see rt_counters.h*/
+rt_bool_t
+rt_table_enable_counters(rt_table_t *rt_table);
+
+void
+rt_table_disable_counters(rt_table_t *rt_table);
+
+/*RT_FALSE if there is no such route or the counters are not enabled*/
+rt_bool_t
+rt_route_counters(rt_table_t *rt_table, char *dest_ip, char mask,
+                  rt_route_counter_t *counter);
+
+/*Bytes held by the routes of the table, lookup structures excluded*/
+uint64_t
+rt_table_mem_usage(rt_table_t *rt_table);
+
+/* dest_ip and gw_ip passed to the APIs above may be IPV4 or IPV6 text
+ * addresses, they are converted to binary once on the way in*/
+
+/*Longest prefix match, addr in host byte order*/
+rt_entry_t *
+rt_lookup_lpm(rt_table_t *rt_table, uint32_t addr);
+
+/*Longest prefix match, addr is 16 bytes in network byte order*/
+rt_entry_t *
+rt_lookup_lpm6(rt_table_t *rt_table, const uint8_t *addr);
+
+/* Gateway and interface a flow takes via a route returned by the
+ * lookups, flow_hash being any hash of the flow. Under rt_read_lock()*/
+static inline rt_nexthop_t *
+rt_entry_nexthop(rt_table_t *rt_table, rt_entry_t *rt_entry, uint32_t flow_hash){
+
+    return rt_nexthop_select(&rt_table->nexthops, RT_LOAD(rt_entry->nh_id), flow_hash);
+}
+
+/* Counts a packet of bytes bytes forwarded by rt_entry, as returned by
+ * the lookups, under the same rt_read_lock(). Nothing unless counters
+ * are enabled, otherwise it only writes memory of the calling CPU, or
+ * thread in user space*/
+static inline void
+rt_entry_count(rt_table_t *rt_table, rt_entry_t *rt_entry, uint32_t bytes){
+
+    rt_counters_t *counters = RT_DEREF(rt_table->counters);
+
+    if(counters)
+        rt_counters_add(counters, rt_entry->cold_id, bytes);
+}
+
+/* rt_lookup_lpm() of the n addrs into results. The lookups of a burst
+ * walk the engine in lockstep, prefetching the next level of each, so
+ * their cache misses overlap instead of adding up*/
+void
+rt_lookup_batch(rt_table_t *rt_table, const uint32_t *addrs,
+                rt_entry_t **results, uint32_t n);
+
+/*Same for IPV6, addrs are n addresses of 16 bytes packed together*/
+void
+rt_lookup_batch6(rt_table_t *rt_table, const uint8_t *addrs,
+                 rt_entry_t **results, uint32_t n);
+
+/* Engines the IPV4 lookups of a table may go through. The trie indexes
+ * the routes whichever the engine, the others are built out of it and
+ * kept in sync with it*/
+typedef enum{
+
+    /*Scans the routes while there are at most RT_SMALL_MAX / 2 of them,
+     * see rt_small.h, the trie beyond. The default, for small tables*/
+    RT_ENGINE_LIST,
+    /*The binary trie only, for tables changing all the time*/
+    RT_ENGINE_TRIE,
+    /*Tree bitmap, a few cache lines per lookup in a fraction of the
+     * memory of DIR-24-8*/
+    RT_ENGINE_TBM,
+    /*DIR-24-8, one or two memory accesses per lookup, for full tables*/
+    RT_ENGINE_DIR24_8,
+    /*Sorted array of address intervals, see rt_interval.h. Predictable
+     * lookups in little memory, but built again after each call adding
+     * or deleting routes : for tables loaded at once with
+     * rt_bulk_load() and seldom changed*/
+    RT_ENGINE_INTERVAL,
+    RT_ENGINE_MAX
+} rt_engine_t;
+
+/* What rt_lookup_lpm() and rt_lookup_batch() dispatch through. All but
+ * the lookups are called with the table locked, attach() builds the
+ * engine out of the routes, detach() frees it once the lookups in
+ * flight are done, add() and remove() follow the changes of the trie.
+ * The lookups fall back to the trie while the structures of the engine
+ * are not there. Members other than the lookups may be NULL*/
+typedef struct rt_engine_ops_{
+
+    rt_engine_t type;
+    const char *name;
+    rt_bool_t (*attach)(rt_table_t *rt_table, uint32_t param);
+    void (*detach)(rt_table_t *rt_table);
+    void (*add)(rt_table_t *rt_table, rt_entry_t *rt_entry);
+    void (*remove)(rt_table_t *rt_table, rt_entry_t *rt_entry);
+    /*After every change of the routes*/
+    void (*changed)(rt_table_t *rt_table);
+    rt_entry_t *(*lookup)(rt_table_t *rt_table, uint32_t addr);
+    void (*lookup_batch)(rt_table_t *rt_table, const uint32_t *addrs,
+                         rt_entry_t **results, uint32_t n);
+} rt_engine_ops_t;
+
+/* Moves the IPV4 lookups of the table to engine, online : the new
+ * engine is built out of the routes while the lookups go on with the
+ * current one, then takes over, the current one being freed once the
+ * lookups in flight are done. The changes of the routes wait meanwhile.
+ * param is for DIR-24-8 the number of /24s which can hold longer
+ * prefixes, 0 picking the default. Right after rt_init_rt_table() it
+ * costs nothing. RT_FALSE, the current engine staying, if out of memory
+ * or engine is not one. An engine running out of memory later on hands
+ * over to the trie*/
+rt_bool_t
+rt_table_set_engine(rt_table_t *rt_table, rt_engine_t engine, uint32_t param);
+
+static inline rt_engine_t
+rt_table_engine(rt_table_t *rt_table){
+
+    return RT_LOAD(rt_table->engine)->type;
+}
+
+const char *
+rt_engine_name(rt_engine_t engine);
+
+/*Same as rt_table_set_engine() with RT_ENGINE_DIR24_8*/
+rt_bool_t
+rt_table_enable_dir24_8(rt_table_t *rt_table, uint32_t tbl8_groups);
+
+/*Back to RT_ENGINE_LIST if the table uses DIR-24-8*/
+void
+rt_table_disable_dir24_8(rt_table_t *rt_table);
+
+/*Same as rt_table_set_engine() with RT_ENGINE_TBM*/
+rt_bool_t
+rt_table_enable_tbm4(rt_table_t *rt_table);
+
+/*Back to RT_ENGINE_LIST if the table uses the tree bitmap*/
+void
+rt_table_disable_tbm4(rt_table_t *rt_table);
+
 #endif /* __RT__ */
@@ -0,0 +1,593 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_bench.c
+ *
+ *    Description:  Single thread benchmark suite of an rt table over a synthetic Internet table
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:41:07 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+/* Usage : rt_bench.exe [n_routes] [v4|v6] [list|trie|tbm|dir24_8|interval]
+ *                      [text|csv|json|routes] [seed]
+ *
+ * Generates n_routes IPV4 or IPV6 routes shaped like an Internet table,
+ * prefix lengths as in the BGP tables, prefixes clustered in a few
+ * allocations and most of them via a few peers. Then times, from one
+ * thread, their insertion, lookups of random addresses and of addresses
+ * skewed towards some routes, one by one and in batches, their update,
+ * dumps, deletion and bulk load, and tells the memory they take. The
+ * engine only applies to IPV4, the one reported is the one left at the
+ * end, the trie if the engine ran out of memory. The interval engine is
+ * built again after each route added or deleted, so it is set once the
+ * routes are inserted, build timing that, and left before they are
+ * deleted. csv and json give the same figures for the scripts tracking
+ * regressions, routes prints the generated table instead. The same
+ * seed generates the same table*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "rt.h"
+
+#define RT_BENCH_N_ADDRS        (1 << 20)   /*Addresses looked up per round*/
+#define RT_BENCH_ROUNDS         4
+#define RT_BENCH_BATCH          64          /*Lookups per read side section*/
+#define RT_BENCH_N_PEERS        32
+#define RT_BENCH_HOME_PEER      80          /*% of the routes of an allocation via its peer*/
+#define RT_BENCH_MAX_METRICS    32
+
+typedef struct rt_bench_len_{
+
+    uint8_t len;
+    uint32_t share;         /*Relative to the other lengths*/
+} rt_bench_len_t;
+
+/*After the IPV4 BGP tables of the last years, plus a few more specifics*/
+static const rt_bench_len_t rt_bench_v4_lens[] = {
+    {8, 2}, {9, 5}, {10, 10}, {11, 20}, {12, 40}, {13, 80}, {14, 120},
+    {15, 150}, {16, 1400}, {17, 800}, {18, 1300}, {19, 2800}, {20, 4000},
+    {21, 4500}, {22, 13000}, {23, 10000}, {24, 57000}, {25, 200},
+    {26, 200}, {27, 200}, {28, 200}, {29, 300}, {30, 300}, {31, 100},
+    {32, 1000}
+};
+
+/*Same for IPV6*/
+static const rt_bench_len_t rt_bench_v6_lens[] = {
+    {19, 2}, {20, 5}, {24, 10}, {28, 100}, {29, 150}, {30, 100}, {31, 50},
+    {32, 1000}, {33, 100}, {34, 100}, {35, 50}, {36, 300}, {37, 50},
+    {38, 100}, {39, 50}, {40, 600}, {41, 50}, {42, 150}, {43, 50},
+    {44, 900}, {45, 150}, {46, 300}, {47, 200}, {48, 4600}, {56, 50},
+    {64, 100}
+};
+
+/*Allocations the prefixes are clustered in, of these many bits*/
+#define RT_BENCH_V4_ALLOC_LEN   13
+#define RT_BENCH_V6_ALLOC_LEN   24
+
+typedef struct rt_bench_route_{
+
+    char dest_ip[RT_IP_ADDR_STRLEN];
+    uint8_t addr[RT_IPV6_ADDR_LEN];     /*Masked, network byte order*/
+    uint8_t mask;
+    uint8_t peer;
+} rt_bench_route_t;
+
+typedef struct rt_bench_metric_{
+
+    const char *name;
+    double value;
+    const char *unit;
+} rt_bench_metric_t;
+
+static rt_table_t rt_table;
+static rt_bench_route_t *routes;
+static uint32_t n_routes;
+static uint8_t family;
+static rt_bench_metric_t metrics[RT_BENCH_MAX_METRICS];
+static uint32_t n_metrics;
+static uint64_t alloc_salt;
+static char peer_gw_ip[RT_BENCH_N_PEERS][RT_IP_ADDR_STRLEN];
+static char peer_oif[RT_BENCH_N_PEERS][RT_IF_NAME_LEN];
+
+static uint64_t
+rt_bench_now_ns(void){
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static uint32_t
+rt_bench_rand(uint64_t *seed){
+
+    *seed = (*seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+    return (uint32_t)(*seed >> 32);
+}
+
+/*Index below n, small ones far more likely*/
+static uint32_t
+rt_bench_rand_skewed(uint64_t *seed, uint32_t n){
+
+    return rt_bench_rand(seed) % (1 + (rt_bench_rand(seed) % n));
+}
+
+static void
+rt_bench_metric(const char *name, double value, const char *unit){
+
+    if(n_metrics == RT_BENCH_MAX_METRICS)
+        return;
+
+    metrics[n_metrics].name = name;
+    metrics[n_metrics].value = value;
+    metrics[n_metrics].unit = unit;
+    n_metrics++;
+}
+
+static void
+rt_bench_mask_addr(uint8_t *addr, uint8_t mask){
+
+    uint32_t i;
+
+    for(i = mask / 8; i < RT_IPV6_ADDR_LEN; i++){
+        addr[i] &= i == mask / 8 ? (uint8_t)(0xFF00 >> (mask % 8)) : 0;
+    }
+}
+
+static uint8_t
+rt_bench_random_len(uint64_t *seed){
+
+    const rt_bench_len_t *lens = family == AF_INET ? rt_bench_v4_lens : rt_bench_v6_lens;
+    uint32_t n = family == AF_INET ?
+        sizeof(rt_bench_v4_lens) / sizeof(rt_bench_v4_lens[0]) :
+        sizeof(rt_bench_v6_lens) / sizeof(rt_bench_v6_lens[0]);
+    uint32_t total = 0, r, i;
+
+    for(i = 0; i < n; i++)
+        total += lens[i].share;
+
+    r = rt_bench_rand(seed) % total;
+
+    for(i = 0; r >= lens[i].share; i++)
+        r -= lens[i].share;
+
+    return lens[i].len;
+}
+
+/*The allocation of each index, unicast space only*/
+static void
+rt_bench_alloc_addr(uint32_t alloc, uint8_t *addr){
+
+    uint64_t seed = alloc_salt + alloc;
+    uint32_t i;
+
+    for(i = 0; i < RT_IPV6_ADDR_LEN; i++)
+        addr[i] = rt_bench_rand(&seed);
+
+    if(family == AF_INET){
+        addr[0] = 1 + (addr[0] % 223);  /*1.0.0.0 to 223.255.255.255*/
+        rt_bench_mask_addr(addr, RT_BENCH_V4_ALLOC_LEN);
+    }
+    else{
+        addr[0] = 0x20 | (addr[0] & 0x1F);    /*2000::/3*/
+        rt_bench_mask_addr(addr, RT_BENCH_V6_ALLOC_LEN);
+    }
+}
+
+static uint32_t
+rt_bench_hash(const uint8_t *addr, uint8_t mask){
+
+    uint32_t hash = 2166136261U, i;
+
+    for(i = 0; i < RT_IPV6_ADDR_LEN; i++)
+        hash = (hash ^ addr[i]) * 16777619U;
+
+    return (hash ^ mask) * 16777619U;
+}
+
+/* Generates the n_routes routes, all different, in random order. Each
+ * takes a length of the distribution above, falls in one of the
+ * n_routes / 256 allocations, a few of them holding most routes, and
+ * is via the peer of the allocation or now and then another one*/
+static rt_bool_t
+rt_bench_generate(uint64_t *seed){
+
+    uint32_t n_allocs = n_routes / 256 + 16;
+    uint32_t n_slots = 1, *slots, alloc, slot, i, attempts = 0;
+    uint32_t addr_len = family == AF_INET ? 4 : RT_IPV6_ADDR_LEN;
+    uint32_t alloc_len = family == AF_INET ? RT_BENCH_V4_ALLOC_LEN : RT_BENCH_V6_ALLOC_LEN;
+    rt_bench_route_t *route;
+    uint8_t alloc_addr[RT_IPV6_ADDR_LEN], top[RT_IPV6_ADDR_LEN];
+
+    while(n_slots < 2 * n_routes)
+        n_slots <<= 1;
+
+    routes = calloc(n_routes, sizeof(rt_bench_route_t));
+    slots = calloc(n_slots, sizeof(uint32_t));   /*Route + 1, 0 if free*/
+
+    if(!routes || !slots)
+        return RT_FALSE;
+
+    for(i = 0; i < n_routes && attempts++ < 8 * n_routes; ){
+
+        route = &routes[i];
+        alloc = rt_bench_rand_skewed(seed, n_allocs);
+        rt_bench_alloc_addr(alloc, alloc_addr);
+
+        memset(route->addr, 0, sizeof(route->addr));
+        for(slot = 0; slot < addr_len; slot++)
+            route->addr[slot] = rt_bench_rand(seed);
+
+        /*Bits of the allocation, then the random ones down to the mask*/
+        memcpy(top, route->addr, sizeof(top));
+        rt_bench_mask_addr(top, alloc_len);
+        for(slot = 0; slot < RT_IPV6_ADDR_LEN; slot++)
+            route->addr[slot] = alloc_addr[slot] | (route->addr[slot] ^ top[slot]);
+
+        route->mask = rt_bench_random_len(seed);
+        rt_bench_mask_addr(route->addr, route->mask);
+
+        route->peer = rt_bench_rand(seed) % 100 < RT_BENCH_HOME_PEER ?
+            alloc % RT_BENCH_N_PEERS : rt_bench_rand_skewed(seed, RT_BENCH_N_PEERS);
+
+        for(slot = rt_bench_hash(route->addr, route->mask) & (n_slots - 1);
+            slots[slot]; slot = (slot + 1) & (n_slots - 1)){
+
+            if(routes[slots[slot] - 1].mask == route->mask &&
+               !memcmp(routes[slots[slot] - 1].addr, route->addr, sizeof(route->addr)))
+                break;
+        }
+
+        if(slots[slot])
+            continue;
+
+        slots[slot] = i + 1;
+        inet_ntop(family, route->addr, route->dest_ip, sizeof(route->dest_ip));
+        i++;
+    }
+
+    free(slots);
+    n_routes = i;
+    return RT_TRUE;
+}
+
+static void
+rt_bench_init_peers(void){
+
+    uint32_t peer;
+
+    for(peer = 0; peer < RT_BENCH_N_PEERS; peer++){
+        if(family == AF_INET)
+            sprintf(peer_gw_ip[peer], "100.64.%u.1", peer);
+        else
+            sprintf(peer_gw_ip[peer], "2001:db8:%x::1", peer);
+        sprintf(peer_oif[peer], "eth%u", peer);
+    }
+}
+
+/*Resident memory of the process*/
+static uint64_t
+rt_bench_rss(void){
+
+    FILE *fp = fopen("/proc/self/statm", "r");
+    unsigned long size, rss = 0;
+
+    if(fp){
+        if(fscanf(fp, "%lu %lu", &size, &rss) != 2)
+            rss = 0;
+        fclose(fp);
+    }
+    return (uint64_t)rss * sysconf(_SC_PAGESIZE);
+}
+
+/* Fills addrs with RT_BENCH_N_ADDRS addresses, random unicast ones or
+ * ones in the generated routes, the route of rank r being picked with a
+ * probability in 1/r like the destinations of real traffic*/
+static void
+rt_bench_addrs(uint64_t *seed, rt_bool_t skewed, uint8_t *addrs, uint32_t *addrs4){
+
+    uint8_t *addr, host[RT_IPV6_ADDR_LEN];
+    rt_bench_route_t *route;
+    double u;
+    uint32_t i, j, r;
+
+    for(i = 0; i < RT_BENCH_N_ADDRS; i++){
+
+        addr = &addrs[i * RT_IPV6_ADDR_LEN];
+
+        for(j = 0; j < RT_IPV6_ADDR_LEN; j++)
+            addr[j] = host[j] = rt_bench_rand(seed);
+
+        if(!skewed){
+            if(family == AF_INET6)
+                addr[0] = 0x20 | (addr[0] & 0x1F);
+        }
+        else{
+            u = (double)rt_bench_rand(seed) / 4294967296.0;
+            r = (uint32_t)exp(u * log((double)n_routes + 1)) - 1;
+            route = &routes[r < n_routes ? r : n_routes - 1];
+
+            /*Random host part within the route*/
+            rt_bench_mask_addr(host, route->mask);
+            for(j = 0; j < RT_IPV6_ADDR_LEN; j++)
+                addr[j] = route->addr[j] | (addr[j] ^ host[j]);
+        }
+
+        addrs4[i] = ((uint32_t)addr[0] << 24) | ((uint32_t)addr[1] << 16) |
+                    ((uint32_t)addr[2] << 8) | addr[3];
+    }
+}
+
+/*ns taking the RT_BENCH_ROUNDS rounds of lookups of addrs*/
+static uint64_t
+rt_bench_lookups(const uint8_t *addrs, const uint32_t *addrs4, rt_bool_t batch,
+                 double *hit_pct){
+
+    rt_entry_t *results[RT_BENCH_BATCH];
+    uint64_t hits = 0, t0 = rt_bench_now_ns();
+    uint32_t round, i, j;
+
+    for(round = 0; round < RT_BENCH_ROUNDS; round++){
+
+        for(i = 0; i < RT_BENCH_N_ADDRS; i += RT_BENCH_BATCH){
+
+            rt_read_lock();
+
+            if(batch){
+                if(family == AF_INET)
+                    rt_lookup_batch(&rt_table, &addrs4[i], results, RT_BENCH_BATCH);
+                else
+                    rt_lookup_batch6(&rt_table, &addrs[i * RT_IPV6_ADDR_LEN],
+                                     results, RT_BENCH_BATCH);
+            }
+            else{
+                for(j = 0; j < RT_BENCH_BATCH; j++){
+                    results[j] = family == AF_INET ?
+                        rt_lookup_lpm(&rt_table, addrs4[i + j]) :
+                        rt_lookup_lpm6(&rt_table, &addrs[(i + j) * RT_IPV6_ADDR_LEN]);
+                }
+            }
+
+            for(j = 0; j < RT_BENCH_BATCH; j++)
+                hits += results[j] != NULL;
+
+            rt_read_unlock();
+        }
+    }
+
+    *hit_pct = hits * 100.0 / ((uint64_t)RT_BENCH_ROUNDS * RT_BENCH_N_ADDRS);
+    return rt_bench_now_ns() - t0;
+}
+
+static rt_bool_t
+rt_bench_discard(void *arg, const void *data, uint32_t len){
+
+    (void)data;
+    *(uint64_t *)arg += len;
+    return RT_TRUE;
+}
+
+static void
+rt_bench_dump(const char *name, rt_dump_format_t format){
+
+    static char buf[RT_SINK_BUF_SIZE];
+    rt_sink_t sink;
+    uint64_t bytes = 0, t0 = rt_bench_now_ns();
+
+    rt_sink_init(&sink, buf, sizeof(buf), rt_bench_discard, &bytes);
+    rt_dump_rt_table_to_sink(&rt_table, &sink, format);
+    rt_bench_metric(name, (double)(rt_bench_now_ns() - t0) / n_routes, "ns/route");
+}
+
+/*RT_ENGINE_MAX if there is no engine named so*/
+static rt_engine_t
+rt_bench_engine(const char *name){
+
+    rt_engine_t engine;
+
+    for(engine = 0; engine < RT_ENGINE_MAX; engine++){
+        if(strcmp(name, rt_engine_name(engine)) == 0)
+            break;
+    }
+    return engine;
+}
+
+static void
+rt_bench_print(const char *output, const char *engine, uint64_t seed){
+
+    const char *fam = family == AF_INET ? "v4" : "v6";
+    uint32_t i;
+
+    if(strcmp(output, "csv") == 0){
+        printf("family,routes,engine,seed,metric,value,unit\n");
+        for(i = 0; i < n_metrics; i++)
+            printf("%s,%u,%s,%llu,%s,%.2f,%s\n", fam, n_routes, engine,
+                (unsigned long long)seed, metrics[i].name, metrics[i].value,
+                metrics[i].unit);
+        return;
+    }
+
+    if(strcmp(output, "json") == 0){
+        printf("{\"family\":\"%s\",\"routes\":%u,\"engine\":\"%s\",\"seed\":%llu,"
+               "\"metrics\":[", fam, n_routes, engine, (unsigned long long)seed);
+        for(i = 0; i < n_metrics; i++)
+            printf("%s\n{\"name\":\"%s\",\"value\":%.2f,\"unit\":\"%s\"}",
+                i ? "," : "", metrics[i].name, metrics[i].value, metrics[i].unit);
+        printf("\n]}\n");
+        return;
+    }
+
+    printf("%u IPV%s routes, engine %s, seed %llu\n", n_routes,
+        family == AF_INET ? "4" : "6", engine, (unsigned long long)seed);
+    for(i = 0; i < n_metrics; i++)
+        printf("%-22s %12.2f %s\n", metrics[i].name, metrics[i].value, metrics[i].unit);
+}
+
+int
+main(int argc, char **argv){
+
+    const char *engine = argc > 3 ? argv[3] : "dir24_8";
+    char *output = argc > 4 ? argv[4] : "text";
+    uint64_t seed = argc > 5 ? strtoull(argv[5], NULL, 0) : 1;
+    uint64_t first_seed = seed, t0, rss;
+    uint8_t *addrs;
+    uint32_t *addrs4, i, n_added = 0;
+    rt_bench_route_t *route;
+    rt_bulk_entry_t *bulk;
+    double hit_pct;
+    rt_engine_t engine_type = rt_bench_engine(engine);
+    rt_bool_t rebuilt;
+
+    n_routes = argc > 1 ? atoi(argv[1]) : 500000;
+    family = argc > 2 && strcmp(argv[2], "v6") == 0 ? AF_INET6 : AF_INET;
+    /*Engine set after the changes one by one*/
+    rebuilt = family == AF_INET && engine_type == RT_ENGINE_INTERVAL;
+    alloc_salt = rt_bench_rand(&seed);
+
+    if(!n_routes)
+        n_routes = 1;
+
+    rt_bench_init_peers();
+
+    addrs = malloc((size_t)RT_BENCH_N_ADDRS * RT_IPV6_ADDR_LEN);
+    addrs4 = malloc(RT_BENCH_N_ADDRS * sizeof(uint32_t));
+    bulk = malloc(n_routes * sizeof(rt_bulk_entry_t));
+
+    if(!addrs || !addrs4 || !bulk || !rt_bench_generate(&seed)){
+        printf("Error : out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    if(strcmp(output, "routes") == 0){
+        for(i = 0; i < n_routes; i++){
+            route = &routes[i];
+            printf("%s/%u %s %s\n", route->dest_ip, route->mask,
+                peer_gw_ip[route->peer], peer_oif[route->peer]);
+        }
+        return 0;
+    }
+
+    rt_init_rt_table(&rt_table);
+
+    /*DIR-24-8 with room for the prefixes longer than /24*/
+    if(family == AF_INET && !rebuilt &&
+       !rt_table_set_engine(&rt_table, engine_type,
+            (n_routes / 32) + RT_DIR24_8_DEF_TBL8_GROUPS)){
+        printf("Error : no engine %s or out of memory\n", engine);
+        return EXIT_FAILURE;
+    }
+
+    /*Inserted one by one, the engine kept up to date*/
+    rss = rt_bench_rss();
+    t0 = rt_bench_now_ns();
+    for(i = 0; i < n_routes; i++){
+        route = &routes[i];
+        n_added += rt_add_new_rt_entry(&rt_table, route->dest_ip, route->mask,
+                        peer_gw_ip[route->peer], peer_oif[route->peer]);
+    }
+    rt_bench_metric("insert", (double)(rt_bench_now_ns() - t0) / n_routes, "ns/op");
+
+    if(n_added != n_routes){
+        printf("Error : %u routes of %u added\n", n_added, n_routes);
+        return EXIT_FAILURE;
+    }
+
+    if(rebuilt){
+        t0 = rt_bench_now_ns();
+        if(!rt_table_set_engine(&rt_table, engine_type, 0)){
+            printf("Error : out of memory\n");
+            return EXIT_FAILURE;
+        }
+        rt_bench_metric("build", (double)(rt_bench_now_ns() - t0) / n_routes, "ns/route");
+    }
+
+    rt_bench_metric("mem_routes", (double)rt_table_mem_usage(&rt_table) / n_routes, "B/route");
+    rt_bench_metric("mem_rss", (double)(rt_bench_rss() - rss) / n_routes, "B/route");
+
+    rt_bench_addrs(&seed, RT_FALSE, addrs, addrs4);
+    t0 = rt_bench_lookups(addrs, addrs4, RT_FALSE, &hit_pct);
+    rt_bench_metric("lookup_random", (double)t0 / RT_BENCH_ROUNDS / RT_BENCH_N_ADDRS, "ns/op");
+    rt_bench_metric("lookup_random_hits", hit_pct, "%");
+
+    rt_bench_addrs(&seed, RT_TRUE, addrs, addrs4);
+    t0 = rt_bench_lookups(addrs, addrs4, RT_FALSE, &hit_pct);
+    rt_bench_metric("lookup_skewed", (double)t0 / RT_BENCH_ROUNDS / RT_BENCH_N_ADDRS, "ns/op");
+    t0 = rt_bench_lookups(addrs, addrs4, RT_TRUE, &hit_pct);
+    rt_bench_metric("lookup_skewed_batch", (double)t0 / RT_BENCH_ROUNDS / RT_BENCH_N_ADDRS, "ns/op");
+
+    /*Each route moved to the next peer*/
+    t0 = rt_bench_now_ns();
+    for(i = 0; i < n_routes; i++){
+        route = &routes[i];
+        route->peer = (route->peer + 1) % RT_BENCH_N_PEERS;
+        rt_update_rt_entry(&rt_table, route->dest_ip, route->mask,
+            peer_gw_ip[route->peer], peer_oif[route->peer]);
+    }
+    rt_bench_metric("update", (double)(rt_bench_now_ns() - t0) / n_routes, "ns/op");
+
+    rt_bench_dump("dump_binary", RT_DUMP_BINARY);
+    rt_bench_dump("dump_csv", RT_DUMP_CSV);
+    rt_bench_dump("dump_json", RT_DUMP_JSON);
+
+    if(rebuilt)
+        rt_table_set_engine(&rt_table, RT_ENGINE_LIST, 0);
+
+    t0 = rt_bench_now_ns();
+    for(i = 0; i < n_routes; i++)
+        rt_delete_rt_entry(&rt_table, routes[i].dest_ip, routes[i].mask);
+    rt_bench_metric("delete", (double)(rt_bench_now_ns() - t0) / n_routes, "ns/op");
+
+    for(i = 0; i < n_routes; i++){
+        route = &routes[i];
+        bulk[i].dest_ip = route->dest_ip;
+        bulk[i].mask = route->mask;
+        bulk[i].gw_ip = peer_gw_ip[route->peer];
+        bulk[i].oif = peer_oif[route->peer];
+    }
+
+    /*Built once, at the end of the load*/
+    if(rebuilt)
+        rt_table_set_engine(&rt_table, engine_type, 0);
+
+    t0 = rt_bench_now_ns();
+    n_added = rt_bulk_load(&rt_table, bulk, n_routes);
+    rt_bench_metric("bulk_load", (double)(rt_bench_now_ns() - t0) / n_routes, "ns/route");
+
+    engine = family == AF_INET ? rt_engine_name(rt_table_engine(&rt_table)) : "tbm6";
+
+    rt_free_rt_table(&rt_table);
+    rt_reclaim_barrier();
+
+    rt_bench_print(output, engine, first_seed);
+
+    free(bulk);
+    free(addrs4);
+    free(addrs);
+    free(routes);
+    return n_added == n_routes ? 0 : EXIT_FAILURE;
+}
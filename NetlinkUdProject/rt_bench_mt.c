@@ -0,0 +1,281 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_bench_mt.c
+ *
+ *    Description:  Lookup throughput of an rt table vs number of reader threads, under route churn
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 03:02:51 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+/* Usage : rt_bench_mt.exe [n_routes] [seconds] [list|trie|tbm|dir24_8|interval]
+ *                         [max_readers] [cache_sets] [updates/s]
+ *
+ * Loads n_routes random IPV4 routes, then for 1, 2, 4 .. max_readers
+ * reader threads measures the lookups/s they achieve together while a
+ * writer thread deletes and re-adds routes at RT_BENCH_UPDATE_RATE, or
+ * updates/s. With cache_sets, each reader looks up through its own
+ * rt_cache_t of that many sets. The interval engine is built again
+ * after each update, the writer falls far behind updates/s with it*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include "rt.h"
+#include "rt_cache.h"
+
+#define RT_BENCH_UPDATE_RATE    50000   /*Updates per second*/
+#define RT_BENCH_N_ADDRS        (1 << 16)
+#define RT_BENCH_BATCH          64      /*Lookups per read side section*/
+#define RT_BENCH_CHURN          4096    /*Routes the writer flaps*/
+
+typedef struct rt_bench_route_{
+
+    char dest_ip[16];
+    uint8_t mask;
+} rt_bench_route_t;
+
+static rt_table_t rt_table;
+static rt_bench_route_t churn[RT_BENCH_CHURN];
+static uint32_t addrs[RT_BENCH_N_ADDRS];
+static volatile int stop;
+static uint32_t cache_sets;
+static uint32_t update_rate = RT_BENCH_UPDATE_RATE;
+
+static uint64_t
+rt_bench_now_ns(void){
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static uint32_t
+rt_bench_rand(uint64_t *seed){
+
+    *seed = (*seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+    return (uint32_t)(*seed >> 32);
+}
+
+/*Mostly /16 to /24 like a real table, some shorter and longer ones*/
+static void
+rt_bench_random_route(uint64_t *seed, rt_bench_route_t *route){
+
+    uint32_t r = rt_bench_rand(seed) % 100;
+    uint32_t addr;
+    struct in_addr in;
+
+    route->mask = r < 60 ? 24 : r < 90 ? 16 + (rt_bench_rand(seed) % 8) :
+                    r < 95 ? 8 + (rt_bench_rand(seed) % 8) :
+                    25 + (rt_bench_rand(seed) % 8);
+    addr = rt_bench_rand(seed) & rt_ipv4_mask(route->mask);
+    in.s_addr = htonl(addr);
+    inet_ntop(AF_INET, &in, route->dest_ip, sizeof(route->dest_ip));
+}
+
+typedef struct rt_bench_reader_{
+
+    pthread_t thread;
+    uint64_t lookups;
+    uint64_t hits;
+    uint64_t cache_hits;
+} __attribute__((aligned(64))) rt_bench_reader_t;
+
+static void *
+rt_bench_reader_fn(void *arg){
+
+    rt_bench_reader_t *reader = arg;
+    rt_entry_t *rt_entry;
+    uint32_t i = 0, j;
+    uint64_t lookups = 0, hits = 0;
+    rt_cache_t cache;
+
+    if(cache_sets && !rt_cache_init(&cache, cache_sets)){
+        printf("Error : rt_cache_init() has failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    while(!stop){
+
+        rt_read_lock();
+
+        for(j = 0; j < RT_BENCH_BATCH; j++){
+            if(cache_sets)
+                rt_entry = rt_cache_lookup(&cache, &rt_table, addrs[i++ & (RT_BENCH_N_ADDRS - 1)]);
+            else
+                rt_entry = rt_lookup_lpm(&rt_table, addrs[i++ & (RT_BENCH_N_ADDRS - 1)]);
+            if(rt_entry && rt_entry->ifindex != 0xFFFFFFFF)
+                hits++;
+        }
+
+        rt_read_unlock();
+        lookups += RT_BENCH_BATCH;
+    }
+
+    reader->lookups = lookups;
+    reader->hits = hits;
+    reader->cache_hits = 0;
+
+    if(cache_sets){
+        reader->cache_hits = cache.hits;
+        rt_cache_destroy(&cache);
+    }
+    rt_epoch_thread_offline();
+    return NULL;
+}
+
+static uint64_t writer_updates;
+
+/*Flaps the churn routes, paced to update_rate*/
+static void *
+rt_bench_writer_fn(void *arg){
+
+    uint64_t start = rt_bench_now_ns(), updates = 0, elapsed;
+    uint32_t i = 0;
+    rt_bench_route_t *route;
+
+    (void)arg;
+
+    while(!stop){
+
+        elapsed = rt_bench_now_ns() - start;
+
+        if(updates * 1000000000ULL > elapsed * update_rate){
+            usleep(100);
+            continue;
+        }
+
+        route = &churn[(i / 2) % RT_BENCH_CHURN];
+
+        if(i++ & 1)
+            rt_add_new_rt_entry(&rt_table, route->dest_ip, route->mask, "10.0.0.1", "lo");
+        else
+            rt_delete_rt_entry(&rt_table, route->dest_ip, route->mask);
+        updates++;
+    }
+
+    writer_updates = updates;
+    return NULL;
+}
+
+/*RT_ENGINE_MAX if there is no engine named so*/
+static rt_engine_t
+rt_bench_engine(const char *name){
+
+    rt_engine_t engine;
+
+    for(engine = 0; engine < RT_ENGINE_MAX; engine++){
+        if(strcmp(name, rt_engine_name(engine)) == 0)
+            break;
+    }
+    return engine;
+}
+
+int
+main(int argc, char **argv){
+
+    uint32_t n_routes = argc > 1 ? atoi(argv[1]) : 500000;
+    uint32_t seconds = argc > 2 ? atoi(argv[2]) : 2;
+    const char *engine = argc > 3 ? argv[3] : "dir24_8";
+    uint32_t max_readers = argc > 4 ? atoi(argv[4]) : sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = 1, lookups, cache_hits, t0, t1;
+    uint32_t i, n_readers;
+    rt_bench_route_t route;
+    rt_bench_reader_t *readers;
+    pthread_t writer;
+
+    if(argc > 5)
+        cache_sets = atoi(argv[5]);
+    if(argc > 6)
+        update_rate = atoi(argv[6]);
+
+    rt_init_rt_table(&rt_table);
+
+    for(i = 0; i < n_routes; i++){
+        rt_bench_random_route(&seed, &route);
+        rt_add_new_rt_entry(&rt_table, route.dest_ip, route.mask, "10.0.0.1", "lo");
+    }
+
+    /*Churn routes are all present when the writer starts*/
+    for(i = 0; i < RT_BENCH_CHURN; i++){
+        rt_bench_random_route(&seed, &churn[i]);
+        rt_add_new_rt_entry(&rt_table, churn[i].dest_ip, churn[i].mask, "10.0.0.1", "lo");
+    }
+
+    /*DIR-24-8 with room for the prefixes longer than /24*/
+    if(!rt_table_set_engine(&rt_table, rt_bench_engine(engine),
+            (n_routes / 32) + RT_DIR24_8_DEF_TBL8_GROUPS)){
+        printf("Error : no engine %s or out of memory\n", engine);
+        return EXIT_FAILURE;
+    }
+
+    for(i = 0; i < RT_BENCH_N_ADDRS; i++)
+        addrs[i] = rt_bench_rand(&seed);
+
+    if(!max_readers)
+        max_readers = 1;
+
+    readers = aligned_alloc(64, max_readers * sizeof(rt_bench_reader_t));
+
+    printf("%u routes, engine %s, writer at %u updates/s, cache of %u sets\n",
+        n_routes, engine, update_rate, cache_sets);
+    printf("%-8s %-14s %-14s %-12s %-10s\n", "readers", "Mlookups/s", "per reader",
+        "updates/s", "cache hit");
+
+    for(n_readers = 1; n_readers <= max_readers;
+            n_readers = n_readers * 2 > max_readers && n_readers < max_readers ?
+                max_readers : n_readers * 2){
+
+        stop = 0;
+        t0 = rt_bench_now_ns();
+        pthread_create(&writer, NULL, rt_bench_writer_fn, NULL);
+        for(i = 0; i < n_readers; i++)
+            pthread_create(&readers[i].thread, NULL, rt_bench_reader_fn, &readers[i]);
+
+        sleep(seconds);
+        stop = 1;
+
+        pthread_join(writer, NULL);
+        lookups = cache_hits = 0;
+        for(i = 0; i < n_readers; i++){
+            pthread_join(readers[i].thread, NULL);
+            lookups += readers[i].lookups;
+            cache_hits += readers[i].cache_hits;
+        }
+        t1 = rt_bench_now_ns();
+
+        printf("%-8u %-14.2f %-14.2f %-12.0f %-9.1f%%\n", n_readers,
+            lookups * 1e3 / (t1 - t0),
+            lookups * 1e3 / (t1 - t0) / n_readers,
+            writer_updates * 1e9 / (t1 - t0),
+            lookups ? cache_hits * 100.0 / lookups : 0);
+    }
+
+    free(readers);
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_cache.c
+ *
+ *    Description:  Cache of recent lookup results in front of an rt table
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 04:12:37 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_cache.h"
+
+rt_bool_t
+rt_cache_init(rt_cache_t *cache, uint32_t n_sets){
+
+    uint32_t bits = 0;
+
+    if(n_sets < RT_CACHE_MIN_SETS)
+        n_sets = RT_CACHE_MIN_SETS;
+
+    while((1U << bits) < n_sets && bits < 31)
+        bits++;
+
+    memset(cache, 0, sizeof(*cache));
+    cache->mem = RT_CALLOC_LARGE(((size_t)sizeof(rt_cache_set_t) << bits) +
+                    sizeof(rt_cache_set_t) - 1);
+
+    if(!cache->mem)
+        return RT_FALSE;
+
+    cache->sets = (rt_cache_set_t *)(((uintptr_t)cache->mem +
+                    sizeof(rt_cache_set_t) - 1) & ~(uintptr_t)(sizeof(rt_cache_set_t) - 1));
+    cache->set_shift = 32 - bits;
+    return RT_TRUE;
+}
+
+void
+rt_cache_destroy(rt_cache_t *cache){
+
+    RT_FREE_LARGE(cache->mem);
+    cache->mem = NULL;
+    cache->sets = NULL;
+}
+
+void
+rt_cache_flush(rt_cache_t *cache){
+
+    memset(cache->sets, 0, sizeof(rt_cache_set_t) << (32 - cache->set_shift));
+}
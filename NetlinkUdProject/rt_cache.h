@@ -0,0 +1,132 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_cache.h
+ *
+ *    Description:  Cache of recent lookup results in front of an rt table
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 04:12:37 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_CACHE__
+#define __RT_CACHE__
+
+#include "rt.h"
+
+/* Set associative cache of recent IPV4 lookup results of a table, in
+ * front of rt_lookup_lpm(). A set is one cache line of RT_CACHE_WAYS
+ * slots, hence a hit costs a single cache line access. A slot is valid
+ * only at the generation of the table it was filled at, any change of
+ * the routes invalidates the whole cache at once by bumping
+ * rt_table_t.generation, without touching the cache.
+ *
+ * A cache is not thread safe : each reader thread (each CPU in the
+ * kernel) owns one, and uses it between rt_read_lock() and
+ * rt_read_unlock() like the lookups themselves. Misses with no route
+ * are not cached*/
+
+#define RT_CACHE_WAYS       4
+#define RT_CACHE_MIN_SETS   64
+#define RT_CACHE_HASH_MUL   0x9E3779B1U     /*2^32 / golden ratio*/
+
+typedef struct rt_cache_slot_{
+
+    uint32_t addr;
+    uint32_t generation;        /*Low 32 bits of the table generation*/
+    rt_entry_t *rt_entry;       /*NULL if empty*/
+} rt_cache_slot_t;
+
+/*Most recently filled slot first*/
+typedef struct rt_cache_set_{
+
+    rt_cache_slot_t slots[RT_CACHE_WAYS];
+} __attribute__((aligned(64))) rt_cache_set_t;
+
+_Static_assert(sizeof(rt_cache_set_t) == 64, "rt_cache_set_t is not a cache line");
+
+typedef struct rt_cache_{
+
+    rt_cache_set_t *sets;
+    uint32_t set_shift;         /*32 - log2 of the number of sets*/
+    /*High 32 bits of the table generation the slots were filled at,
+     * the cache is flushed when they change so a slot never outlives
+     * 2^32 generations*/
+    uint32_t generation_hi;
+    uint64_t hits;
+    uint64_t misses;
+    void *mem;                  /*Unaligned block holding the sets*/
+} rt_cache_t;
+
+/*n_sets is rounded up to a power of 2, RT_CACHE_MIN_SETS at least*/
+rt_bool_t
+rt_cache_init(rt_cache_t *cache, uint32_t n_sets);
+
+void
+rt_cache_destroy(rt_cache_t *cache);
+
+/*Empties the cache, the counters are kept*/
+void
+rt_cache_flush(rt_cache_t *cache);
+
+static inline rt_entry_t *
+rt_cache_lookup(rt_cache_t *cache, rt_table_t *rt_table, uint32_t addr){
+
+    /*Pairs with the store release of rt_table_changed(), the routes
+     * looked up below are at least as recent as generation*/
+    uint64_t generation = RT_LOAD_ACQUIRE(rt_table->generation);
+    uint32_t tag = (uint32_t)generation;
+    rt_cache_set_t *set;
+    rt_entry_t *rt_entry;
+    int i;
+
+    if((uint32_t)(generation >> 32) != cache->generation_hi){
+        rt_cache_flush(cache);
+        cache->generation_hi = (uint32_t)(generation >> 32);
+    }
+
+    set = &cache->sets[(addr * RT_CACHE_HASH_MUL) >> cache->set_shift];
+
+    for(i = 0; i < RT_CACHE_WAYS; i++){
+        if(set->slots[i].addr == addr &&
+           set->slots[i].generation == tag && set->slots[i].rt_entry){
+            cache->hits++;
+            return set->slots[i].rt_entry;
+        }
+    }
+
+    cache->misses++;
+    rt_entry = rt_lookup_lpm(rt_table, addr);
+
+    if(rt_entry){
+        /*The least recently filled slot is evicted*/
+        memmove(&set->slots[1], &set->slots[0],
+            (RT_CACHE_WAYS - 1) * sizeof(rt_cache_slot_t));
+        set->slots[0].addr = addr;
+        set->slots[0].generation = tag;
+        set->slots[0].rt_entry = rt_entry;
+    }
+
+    return rt_entry;
+}
+
+#endif /* __RT_CACHE__ */
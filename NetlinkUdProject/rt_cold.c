@@ -0,0 +1,113 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_cold.c
+ *
+ *    Description:  Implementation of the side table holding the rarely used text fields of the routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 02:58:44 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_cold.h"
+
+void
+rt_cold_table_init(rt_cold_table_t *cold_table){
+
+    memset(cold_table, 0, sizeof(rt_cold_table_t));
+    cold_table->free_id = RT_COLD_INVALID_ID;
+}
+
+void
+rt_cold_table_destroy(rt_cold_table_t *cold_table){
+
+    uint32_t i;
+
+    for(i = 0; i < cold_table->n_chunks; i++)
+        RT_FREE(cold_table->chunks[i]);
+
+    RT_FREE(cold_table->chunks);
+    rt_cold_table_init(cold_table);
+}
+
+static rt_bool_t
+rt_cold_add_chunk(rt_cold_table_t *cold_table){
+
+    rt_entry_cold_t **chunks;
+    rt_entry_cold_t *chunk;
+    uint32_t capacity;
+
+    if(cold_table->n_chunks == cold_table->chunks_capacity){
+
+        capacity = cold_table->chunks_capacity ? cold_table->chunks_capacity * 2 : 16;
+        chunks = RT_CALLOC(capacity * sizeof(rt_entry_cold_t *));
+
+        if(!chunks)
+            return RT_FALSE;
+
+        if(cold_table->n_chunks)
+            memcpy(chunks, cold_table->chunks,
+                cold_table->n_chunks * sizeof(rt_entry_cold_t *));
+        RT_FREE(cold_table->chunks);
+        cold_table->chunks = chunks;
+        cold_table->chunks_capacity = capacity;
+    }
+
+    chunk = RT_CALLOC(RT_COLD_CHUNK_SIZE * sizeof(rt_entry_cold_t));
+
+    if(!chunk)
+        return RT_FALSE;
+
+    cold_table->chunks[cold_table->n_chunks++] = chunk;
+    return RT_TRUE;
+}
+
+uint32_t
+rt_cold_alloc(rt_cold_table_t *cold_table){
+
+    uint32_t cold_id;
+
+    if(cold_table->free_id != RT_COLD_INVALID_ID){
+        cold_id = cold_table->free_id;
+        cold_table->free_id = rt_cold_get(cold_table, cold_id)->next_free;
+    }
+    else{
+        if(cold_table->next_id == cold_table->n_chunks * RT_COLD_CHUNK_SIZE &&
+            !rt_cold_add_chunk(cold_table))
+            return RT_COLD_INVALID_ID;
+        cold_id = cold_table->next_id++;
+    }
+
+    cold_table->n_entries++;
+    return cold_id;
+}
+
+void
+rt_cold_free(rt_cold_table_t *cold_table, uint32_t cold_id){
+
+    rt_entry_cold_t *cold = rt_cold_get(cold_table, cold_id);
+
+    memset(cold, 0, sizeof(rt_entry_cold_t));
+    cold->next_free = cold_table->free_id;
+    cold_table->free_id = cold_id;
+    cold_table->n_entries--;
+}
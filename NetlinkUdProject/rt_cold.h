@@ -0,0 +1,81 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_cold.h
+ *
+ *    Description:  Side table holding the rarely used text fields of the routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 02:58:44 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_COLD__
+#define __RT_COLD__
+
+#include "rt_common.h"
+
+/* The text form of a route, as configured by the user, is needed only
+ * to dump the table. It is kept away from rt_entry_t in chunks of this
+ * side table, so that lookups never pull it into the cache. The next
+ * hops keep their own*/
+
+#define RT_COLD_CHUNK_SHIFT     10
+#define RT_COLD_CHUNK_SIZE      (1U << RT_COLD_CHUNK_SHIFT)
+#define RT_COLD_INVALID_ID      0xFFFFFFFFU
+
+typedef struct rt_entry_cold_{
+
+    char dest_ip[RT_IP_ADDR_STRLEN];
+    uint32_t next_free;
+} rt_entry_cold_t;
+
+typedef struct rt_cold_table_{
+
+    rt_entry_cold_t **chunks;
+    uint32_t n_chunks;
+    uint32_t chunks_capacity;
+    uint32_t next_id;       /*Ids below this have been handed out once*/
+    uint32_t free_id;       /*Head of the list of recycled ids*/
+    uint32_t n_entries;
+} rt_cold_table_t;
+
+void
+rt_cold_table_init(rt_cold_table_t *cold_table);
+
+void
+rt_cold_table_destroy(rt_cold_table_t *cold_table);
+
+/*Returns RT_COLD_INVALID_ID on alloc failure*/
+uint32_t
+rt_cold_alloc(rt_cold_table_t *cold_table);
+
+void
+rt_cold_free(rt_cold_table_t *cold_table, uint32_t cold_id);
+
+static inline rt_entry_cold_t *
+rt_cold_get(rt_cold_table_t *cold_table, uint32_t cold_id){
+
+    return &cold_table->chunks[cold_id >> RT_COLD_CHUNK_SHIFT]
+                [cold_id & (RT_COLD_CHUNK_SIZE - 1)];
+}
+
+#endif /* __RT_COLD__ */
@@ -0,0 +1,155 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_common.h
+ *
+ *    Description:  This file contains common routines and definitions to be used by the
+ *                  routing table code compiled in kernel space as well as in user space
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:05:12 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_COMMON__
+#define __RT_COMMON__
+
+/* Files like rt_trie.c are compiled as is into the LKM (kbuild defines
+ * __KERNEL__) and into user space programs. Whatever differs between
+ * the two worlds is hidden behind the macros below*/
+
+#ifdef __KERNEL__
+#include <linux/types.h>    /*for uint32_t/uint8_t*/
+#include <linux/slab.h>     /*kmalloc/kfree*/
+#include <linux/string.h>
+#include <linux/bitops.h>   /*hweight64*/
+#include <linux/rcupdate.h>
+#include <linux/mm.h>       /*kvzalloc/kvfree*/
+#include <linux/sort.h>
+#include <linux/prefetch.h>
+
+#define RT_CALLOC(size)     kzalloc(size, GFP_KERNEL)
+#define RT_FREE(ptr)        kfree(ptr)
+/*Blocks which may be too big for kmalloc*/
+#define RT_CALLOC_LARGE(size)   kvzalloc(size, GFP_KERNEL)
+#define RT_FREE_LARGE(ptr)      kvfree(ptr)
+/*No libgcc in kernel, __builtin_popcountll may end up as a call to it*/
+#define RT_POPCOUNT64(x)    hweight64(x)
+#define RT_SORT(base, n, size, cmp) sort(base, n, size, cmp, NULL)
+#define RT_PREFETCH(ptr)    prefetch(ptr)
+
+/*Before 6.3 the single argument form was called kvfree_rcu()*/
+#ifndef kvfree_rcu_mightsleep
+#define kvfree_rcu_mightsleep(ptr)  kvfree_rcu(ptr)
+#endif
+
+#define RT_PUBLISH(p, v)        rcu_assign_pointer(p, v)
+#define RT_DEREF(p)             rcu_dereference(p)
+#define RT_LOAD(x)              READ_ONCE(x)
+#define RT_STORE(x, v)          WRITE_ONCE(x, v)
+#define RT_STORE_RELEASE(x, v)  smp_store_release(&(x), v)
+#define RT_LOAD_ACQUIRE(x)      smp_load_acquire(&(x))
+#define RT_FREE_DEFERRED(ptr)   kvfree_rcu_mightsleep(ptr)
+#define RT_SYNCHRONIZE()        synchronize_rcu()
+#else
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rt_epoch.h"
+
+#define RT_CALLOC(size)     calloc(1, size)
+#define RT_FREE(ptr)        free(ptr)
+#define RT_CALLOC_LARGE(size)   calloc(1, size)
+#define RT_FREE_LARGE(ptr)      free(ptr)
+#define RT_POPCOUNT64(x)    __builtin_popcountll(x)
+#define RT_SORT(base, n, size, cmp) qsort(base, n, size, cmp)
+#define RT_PREFETCH(ptr)    __builtin_prefetch(ptr)
+
+#define RT_PUBLISH(p, v)        __atomic_store_n(&(p), v, __ATOMIC_RELEASE)
+#define RT_DEREF(p)             __atomic_load_n(&(p), __ATOMIC_ACQUIRE)
+#define RT_LOAD(x)              __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define RT_STORE(x, v)          __atomic_store_n(&(x), v, __ATOMIC_RELAXED)
+#define RT_STORE_RELEASE(x, v)  __atomic_store_n(&(x), v, __ATOMIC_RELEASE)
+#define RT_LOAD_ACQUIRE(x)      __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define RT_FREE_DEFERRED(ptr)   rt_epoch_retire(NULL, ptr, rt_epoch_free, NULL)
+#define RT_SYNCHRONIZE()        rt_epoch_synchronize()
+#endif
+
+/* Lookups may run concurrently with one writer, under rcu_read_lock()
+ * only in the kernel, rt_epoch_read_lock() in user space. Hence the lookup structures are never left
+ * inconsistent : writers publish a pointer with RT_PUBLISH() once what
+ * it points to is complete, readers follow it with RT_DEREF(), single
+ * words updated in place go through RT_LOAD()/RT_STORE(). Memory which
+ * readers may still see once unlinked is given to RT_FREE_DEFERRED(),
+ * and RT_SYNCHRONIZE() waits for all the readers in flight before an
+ * unlinked slot gets reused*/
+
+typedef enum rt_bool_{
+
+    RT_FALSE,
+    RT_TRUE
+} rt_bool_t;
+
+/* Batched lookups walk up to RT_LOOKUP_GROUP lookups in lockstep, one
+ * level of each per round, prefetching the next level of each so that
+ * their cache misses overlap*/
+#define RT_LOOKUP_GROUP     32
+
+/*IPV4 addresses are handled in host byte order everywhere in rt code*/
+#define RT_IPV4_MAX_MASK    32
+#define RT_IPV6_MAX_MASK    128
+#define RT_IPV6_ADDR_LEN    16
+/*Long enough for dotted IPV4 as well as IPV6 text addresses*/
+#define RT_IP_ADDR_STRLEN   46
+#define RT_IF_NAME_LEN      32
+
+static inline uint32_t
+rt_ipv4_mask(uint8_t mask){
+
+    return mask ? (0xFFFFFFFF << (RT_IPV4_MAX_MASK - mask)) : 0;
+}
+
+static inline rt_bool_t
+rt_is_ipv6(char *ip){
+
+    return strchr(ip, ':') ? RT_TRUE : RT_FALSE;
+}
+
+/*Clears the bits of addr (network byte order) beyond mask*/
+static inline void
+rt_addr_apply_mask(uint8_t *addr, uint8_t addr_len, uint8_t mask){
+
+    uint8_t i;
+
+    for(i = 0; i < addr_len; i++, mask = mask > 8 ? mask - 8 : 0){
+        if(mask < 8)
+            addr[i] &= (uint8_t)(0xFF << (8 - mask));
+    }
+}
+
+/*Returns the bit of addr at position pos, pos 0 being the MSB*/
+static inline uint32_t
+rt_ipv4_bit(uint32_t addr, uint8_t pos){
+
+    return (addr >> (RT_IPV4_MAX_MASK - 1 - pos)) & 1;
+}
+
+#endif /* __RT_COMMON__ */
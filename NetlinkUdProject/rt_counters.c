@@ -0,0 +1,188 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_counters.c
+ *
+ *    Description:  Implementation of the per CPU counters of the routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 09:14:08 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_counters.h"
+#ifndef __KERNEL__
+#include <unistd.h>     /*sysconf*/
+#endif
+
+#define RT_COUNTERS_MAX_SLOTS   256
+
+static rt_counters_chunk_t
+rt_counters_chunk_alloc(rt_counters_t *counters){
+
+#ifdef __KERNEL__
+    return __alloc_percpu(RT_COLD_CHUNK_SIZE * sizeof(rt_route_counter_t),
+                __alignof__(rt_route_counter_t));
+#else
+    return RT_CALLOC_LARGE(((uint64_t)counters->n_slots << RT_COLD_CHUNK_SHIFT) *
+                sizeof(rt_route_counter_t));
+#endif
+}
+
+static void
+rt_counters_chunk_free(rt_counters_chunk_t chunk){
+
+#ifdef __KERNEL__
+    free_percpu(chunk);
+#else
+    RT_FREE_LARGE(chunk);
+#endif
+}
+
+rt_counters_t *
+rt_counters_create(void){
+
+    rt_counters_t *counters = RT_CALLOC(sizeof(rt_counters_t));
+#ifndef __KERNEL__
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if(!counters)
+        return NULL;
+
+    /*As many slots as CPUs, as many threads doing lookups at once*/
+    for(counters->n_slots = 1; counters->n_slots < n_cpus &&
+            counters->n_slots < RT_COUNTERS_MAX_SLOTS; counters->n_slots *= 2);
+#endif
+    return counters;
+}
+
+void
+rt_counters_destroy(rt_counters_t *counters){
+
+    uint32_t i;
+
+    if(!counters)
+        return;
+
+    for(i = 0; i < counters->n_chunks; i++)
+        rt_counters_chunk_free(counters->chunks[i]);
+
+    RT_FREE(counters->chunks);
+    RT_FREE(counters);
+}
+
+/*Allocates the chunks up to the one of cold_id*/
+static rt_bool_t
+rt_counters_grow(rt_counters_t *counters, uint32_t cold_id){
+
+    uint32_t chunk = cold_id >> RT_COLD_CHUNK_SHIFT, capacity;
+    rt_counters_chunk_t *chunks, *old;
+
+    while(counters->n_chunks <= chunk){
+
+        if(counters->n_chunks == counters->chunks_capacity){
+
+            capacity = counters->chunks_capacity ? counters->chunks_capacity * 2 : 16;
+            chunks = RT_CALLOC(capacity * sizeof(rt_counters_chunk_t));
+
+            if(!chunks)
+                return RT_FALSE;
+
+            old = counters->chunks;
+            if(counters->n_chunks)
+                memcpy(chunks, old,
+                    counters->n_chunks * sizeof(rt_counters_chunk_t));
+            /*Old array freed only once no reader can load it anymore*/
+            RT_PUBLISH(counters->chunks, chunks);
+            RT_FREE_DEFERRED(old);
+            counters->chunks_capacity = capacity;
+        }
+
+        counters->chunks[counters->n_chunks] = rt_counters_chunk_alloc(counters);
+
+        if(!counters->chunks[counters->n_chunks])
+            return RT_FALSE;
+
+        /*The chunk is zeroed, lookups may count in it from now on*/
+        RT_STORE_RELEASE(counters->n_chunks, counters->n_chunks + 1);
+    }
+    return RT_TRUE;
+}
+
+rt_bool_t
+rt_counters_reset(rt_counters_t *counters, uint32_t cold_id){
+
+    rt_counters_chunk_t chunk;
+    uint32_t idx = cold_id & (RT_COLD_CHUNK_SIZE - 1);
+#ifdef __KERNEL__
+    int cpu;
+#else
+    uint32_t slot;
+#endif
+
+    if(cold_id >> RT_COLD_CHUNK_SHIFT >= counters->n_chunks)
+        return rt_counters_grow(counters, cold_id);
+
+    chunk = counters->chunks[cold_id >> RT_COLD_CHUNK_SHIFT];
+#ifdef __KERNEL__
+    for_each_possible_cpu(cpu)
+        memset(per_cpu_ptr(chunk + idx, cpu), 0, sizeof(rt_route_counter_t));
+#else
+    for(slot = 0; slot < counters->n_slots; slot++)
+        memset(&chunk[(slot << RT_COLD_CHUNK_SHIFT) + idx], 0,
+            sizeof(rt_route_counter_t));
+#endif
+    return RT_TRUE;
+}
+
+void
+rt_counters_read(rt_counters_t *counters, uint32_t cold_id,
+                 rt_route_counter_t *sum){
+
+    rt_counters_chunk_t chunk;
+    uint32_t idx = cold_id & (RT_COLD_CHUNK_SIZE - 1);
+    rt_route_counter_t *counter;
+#ifdef __KERNEL__
+    int cpu;
+#else
+    uint32_t slot;
+#endif
+
+    memset(sum, 0, sizeof(rt_route_counter_t));
+
+    if(cold_id >> RT_COLD_CHUNK_SHIFT >= counters->n_chunks)
+        return;
+
+    chunk = counters->chunks[cold_id >> RT_COLD_CHUNK_SHIFT];
+#ifdef __KERNEL__
+    for_each_possible_cpu(cpu){
+        counter = per_cpu_ptr(chunk + idx, cpu);
+        sum->hits += RT_LOAD(counter->hits);
+        sum->bytes += RT_LOAD(counter->bytes);
+    }
+#else
+    for(slot = 0; slot < counters->n_slots; slot++){
+        counter = &chunk[(slot << RT_COLD_CHUNK_SHIFT) + idx];
+        sum->hits += RT_LOAD(counter->hits);
+        sum->bytes += RT_LOAD(counter->bytes);
+    }
+#endif
+}
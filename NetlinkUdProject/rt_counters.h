@@ -0,0 +1,117 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_counters.h
+ *
+ *    Description:  Per CPU hit and byte counters of the routes of a routing table
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 09:14:08 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_COUNTERS__
+#define __RT_COUNTERS__
+
+#include "rt_common.h"
+#include "rt_cold.h"
+#ifdef __KERNEL__
+#include <linux/percpu.h>
+#endif
+
+/* Hits and bytes of each route, counted by the lookup side without any
+ * write to a cache line another CPU writes too. rt_entry_t has no room
+ * left, the counters of a route are found by its cold id, which is
+ * dense, in chunks of RT_COLD_CHUNK_SIZE routes like the cold table.
+ * In the kernel a chunk is per CPU memory. In user space it holds
+ * n_slots copies of the counters, a thread counting in the copy of the
+ * number of its rt_epoch_record_t, so threads share a copy only when
+ * there are more of them than slots, and the adds are atomic for that
+ * case. The copies are summed on read only*/
+
+typedef struct rt_route_counter_{
+
+    uint64_t hits;
+    uint64_t bytes;
+} rt_route_counter_t;
+
+#ifdef __KERNEL__
+typedef rt_route_counter_t __percpu *rt_counters_chunk_t;
+#else
+typedef rt_route_counter_t *rt_counters_chunk_t;
+#endif
+
+typedef struct rt_counters_{
+
+    rt_counters_chunk_t *chunks;
+    uint32_t n_chunks;      /*Read by lookups, chunks is at least that long*/
+    uint32_t chunks_capacity;
+#ifndef __KERNEL__
+    uint32_t n_slots;       /*Power of 2*/
+#endif
+} rt_counters_t;
+
+/*NULL on alloc failure*/
+rt_counters_t *
+rt_counters_create(void);
+
+/*Once the lookups which may count are over*/
+void
+rt_counters_destroy(rt_counters_t *counters);
+
+/* Zeroes the counters of the route of cold_id, a new route or one
+ * reusing the id of a deleted one, allocating them if needed. Counts of
+ * lookups of a deleted route still in flight may land in them. RT_FALSE
+ * on alloc failure, the route is then not counted*/
+rt_bool_t
+rt_counters_reset(rt_counters_t *counters, uint32_t cold_id);
+
+/*Sum of the per CPU counters of the route of cold_id*/
+void
+rt_counters_read(rt_counters_t *counters, uint32_t cold_id,
+                 rt_route_counter_t *sum);
+
+/*Lookup side, under rt_read_lock()*/
+static inline void
+rt_counters_add(rt_counters_t *counters, uint32_t cold_id, uint64_t bytes){
+
+    uint32_t chunk = cold_id >> RT_COLD_CHUNK_SHIFT;
+    rt_counters_chunk_t *chunks;
+    rt_counters_chunk_t counter;
+
+    /*Pairs with the release in rt_counters_reset(), chunks is as long*/
+    if(chunk >= RT_LOAD_ACQUIRE(counters->n_chunks))
+        return;
+
+    chunks = RT_DEREF(counters->chunks);
+#ifdef __KERNEL__
+    counter = chunks[chunk] + (cold_id & (RT_COLD_CHUNK_SIZE - 1));
+    this_cpu_inc(counter->hits);
+    this_cpu_add(counter->bytes, bytes);
+#else
+    counter = &chunks[chunk][((rt_epoch_self->id & (counters->n_slots - 1)) <<
+                RT_COLD_CHUNK_SHIFT) + (cold_id & (RT_COLD_CHUNK_SIZE - 1))];
+    __atomic_fetch_add(&counter->hits, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counter->bytes, bytes, __ATOMIC_RELAXED);
+#endif
+}
+
+#endif /* __RT_COUNTERS__ */
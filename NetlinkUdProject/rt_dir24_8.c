@@ -0,0 +1,459 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_dir24_8.c
+ *
+ *    Description:  Implementation of DIR-24-8 compiled lookup table for IPV4 routing tables
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 11:02:27 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_dir24_8.h"
+
+#define RT_DIR24_8_DEF_NH   (1U << 16)
+
+/* The tables are too big for kmalloc/calloc, in kernel space they are
+ * vmalloc'ed, in user space they are mmap'ed preferably from the huge
+ * page pool so that the 64MB tbl24 costs few TLB entries. If no huge
+ * pages are reserved (/proc/sys/vm/nr_hugepages), we fall back to
+ * normal pages and ask for transparent huge pages instead*/
+#ifdef __KERNEL__
+#include <linux/vmalloc.h>
+
+static void *
+rt_dir24_8_mem_alloc(size_t size, rt_bool_t *huge_pages){
+
+    *huge_pages = RT_FALSE;
+    return vzalloc(size);
+}
+
+static void
+rt_dir24_8_mem_free(void *ptr, size_t size){
+
+    vfree(ptr);
+}
+
+/*For tables which lookups may still be reading*/
+static void
+rt_dir24_8_mem_free_deferred(void *ptr, size_t size){
+
+    kvfree_rcu_mightsleep(ptr);
+}
+#else
+#include <sys/mman.h>
+
+#define RT_HUGE_PAGE_SIZE   (2UL << 20)
+#define RT_HUGE_PAGE_ROUNDUP(size)  \
+    (((size) + RT_HUGE_PAGE_SIZE - 1) & ~(RT_HUGE_PAGE_SIZE - 1))
+
+static void *
+rt_dir24_8_mem_alloc(size_t size, rt_bool_t *huge_pages){
+
+    void *ptr;
+
+    size = RT_HUGE_PAGE_ROUNDUP(size);
+#ifdef MAP_HUGETLB
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if(ptr != MAP_FAILED){
+        *huge_pages = RT_TRUE;
+        return ptr;
+    }
+#endif
+    *huge_pages = RT_FALSE;
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(ptr == MAP_FAILED)
+        return NULL;
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    return ptr;
+}
+
+static void
+rt_dir24_8_mem_free(void *ptr, size_t size){
+
+    if(ptr)
+        munmap(ptr, RT_HUGE_PAGE_ROUNDUP(size));
+}
+
+static void
+rt_dir24_8_mem_retired(void *arg, void *ptr){
+
+    rt_dir24_8_mem_free(ptr, (size_t)arg);
+}
+
+static void
+rt_dir24_8_mem_free_deferred(void *ptr, size_t size){
+
+    rt_epoch_retire(NULL, ptr, rt_dir24_8_mem_retired, (void *)size);
+}
+#endif
+
+static inline uint32_t
+rt_dir24_8_entry(uint32_t idx, uint8_t depth){
+
+    return RT_DIR24_8_VALID | ((uint32_t)depth << RT_DIR24_8_DEPTH_SHIFT) | idx;
+}
+
+static inline uint8_t
+rt_dir24_8_depth(uint32_t e){
+
+    return (e & RT_DIR24_8_DEPTH_MASK) >> RT_DIR24_8_DEPTH_SHIFT;
+}
+
+static rt_bool_t
+rt_dir24_8_nh_grow(rt_dir24_8_t *dir){
+
+    uint32_t new_capacity;
+    void **new_nh_tbl;
+    uint32_t *new_free_nh;
+    rt_bool_t huge;
+
+    if(dir->nh_capacity >= RT_DIR24_8_INVALID_IDX)
+        return RT_FALSE;
+
+    new_capacity = dir->nh_capacity ? dir->nh_capacity * 2 : RT_DIR24_8_DEF_NH;
+    if(new_capacity > RT_DIR24_8_INVALID_IDX)
+        new_capacity = RT_DIR24_8_INVALID_IDX;
+
+    new_nh_tbl = rt_dir24_8_mem_alloc(new_capacity * sizeof(void *), &huge);
+    new_free_nh = rt_dir24_8_mem_alloc(new_capacity * sizeof(uint32_t), &huge);
+
+    if(!new_nh_tbl || !new_free_nh){
+        rt_dir24_8_mem_free(new_nh_tbl, new_capacity * sizeof(void *));
+        rt_dir24_8_mem_free(new_free_nh, new_capacity * sizeof(uint32_t));
+        return RT_FALSE;
+    }
+
+    if(dir->nh_capacity){
+        memcpy(new_nh_tbl, dir->nh_tbl, dir->nh_capacity * sizeof(void *));
+        memcpy(new_free_nh, dir->free_nh, dir->n_free_nh * sizeof(uint32_t));
+        rt_dir24_8_mem_free_deferred(dir->nh_tbl, dir->nh_capacity * sizeof(void *));
+        rt_dir24_8_mem_free(dir->free_nh, dir->nh_capacity * sizeof(uint32_t));
+    }
+
+    RT_PUBLISH(dir->nh_tbl, new_nh_tbl);
+    dir->free_nh = new_free_nh;
+    dir->nh_capacity = new_capacity;
+    return RT_TRUE;
+}
+
+/* Pops a free slot (group or nh index) which no lookup can be reading,
+ * waiting for the lookups in flight if wait is set and only recently
+ * freed slots are left. RT_DIR24_8_INVALID_IDX if there is none*/
+static uint32_t
+rt_dir24_8_slot_pop(uint32_t *stack, uint32_t *n_free, uint32_t *n_safe,
+                    rt_bool_t wait){
+
+    uint32_t slot;
+
+    if(!*n_safe){
+
+        if(!*n_free || !wait)
+            return RT_DIR24_8_INVALID_IDX;
+
+        RT_SYNCHRONIZE();
+        *n_safe = *n_free;
+    }
+
+    slot = stack[*n_safe - 1];
+    stack[*n_safe - 1] = stack[*n_free - 1];
+    (*n_safe)--;
+    (*n_free)--;
+    return slot;
+}
+
+static uint32_t
+rt_dir24_8_nh_alloc(rt_dir24_8_t *dir, void *data){
+
+    uint32_t idx = rt_dir24_8_slot_pop(dir->free_nh, &dir->n_free_nh,
+                        &dir->n_safe_nh, RT_FALSE);
+
+    /*Rather take a fresh index than wait for the recycled ones*/
+    if(idx == RT_DIR24_8_INVALID_IDX && dir->nh_next < dir->nh_capacity)
+        idx = dir->nh_next++;
+
+    if(idx == RT_DIR24_8_INVALID_IDX)
+        idx = rt_dir24_8_slot_pop(dir->free_nh, &dir->n_free_nh,
+                &dir->n_safe_nh, RT_TRUE);
+
+    if(idx == RT_DIR24_8_INVALID_IDX){
+        if(!rt_dir24_8_nh_grow(dir))
+            return RT_DIR24_8_INVALID_IDX;
+        idx = dir->nh_next++;
+    }
+
+    RT_STORE(dir->nh_tbl[idx], data);
+    return idx;
+}
+
+/*The stale pointer is left in place for the lookups which already read
+ * idx, the data it points to is freed after a grace period as well*/
+static void
+rt_dir24_8_nh_free(rt_dir24_8_t *dir, uint32_t idx){
+
+    dir->free_nh[dir->n_free_nh++] = idx;
+}
+
+rt_dir24_8_t *
+rt_dir24_8_create(uint32_t tbl8_groups){
+
+    uint32_t g;
+    rt_bool_t huge;
+    rt_dir24_8_t *dir = RT_CALLOC(sizeof(rt_dir24_8_t));
+
+    if(!dir)
+        return NULL;
+
+    if(!tbl8_groups || tbl8_groups > RT_DIR24_8_IDX_MASK)
+        tbl8_groups = RT_DIR24_8_DEF_TBL8_GROUPS;
+
+    dir->tbl24 = rt_dir24_8_mem_alloc(RT_DIR24_8_TBL24_SIZE * sizeof(uint32_t),
+                    &dir->huge_pages);
+    dir->tbl8 = rt_dir24_8_mem_alloc(
+                    tbl8_groups * RT_DIR24_8_GROUP_SIZE * sizeof(uint32_t), &huge);
+    dir->free_groups = rt_dir24_8_mem_alloc(tbl8_groups * sizeof(uint32_t), &huge);
+    dir->n_tbl8_groups = tbl8_groups;
+
+    if(!dir->tbl24 || !dir->tbl8 || !dir->free_groups ||
+        !rt_dir24_8_nh_grow(dir)){
+        rt_dir24_8_destroy(dir);
+        return NULL;
+    }
+
+    for(g = 0; g < tbl8_groups; g++)
+        dir->free_groups[g] = tbl8_groups - 1 - g;
+    dir->n_free_groups = tbl8_groups;
+    dir->n_safe_groups = tbl8_groups;
+
+    return dir;
+}
+
+void
+rt_dir24_8_destroy(rt_dir24_8_t *dir){
+
+    rt_dir24_8_mem_free(dir->tbl24, RT_DIR24_8_TBL24_SIZE * sizeof(uint32_t));
+    rt_dir24_8_mem_free(dir->tbl8,
+        dir->n_tbl8_groups * RT_DIR24_8_GROUP_SIZE * sizeof(uint32_t));
+    rt_dir24_8_mem_free(dir->free_groups, dir->n_tbl8_groups * sizeof(uint32_t));
+    rt_dir24_8_mem_free(dir->nh_tbl, dir->nh_capacity * sizeof(void *));
+    rt_dir24_8_mem_free(dir->free_nh, dir->nh_capacity * sizeof(uint32_t));
+    RT_FREE(dir);
+}
+
+/*Overwrite the tbl8 entries which are not programmed by a longer prefix*/
+static void
+rt_dir24_8_tbl8_set(rt_dir24_8_t *dir, uint32_t group, uint32_t start,
+                    uint32_t count, uint32_t new_e, uint8_t plen){
+
+    uint32_t *e = &dir->tbl8[group * RT_DIR24_8_GROUP_SIZE + start];
+
+    for(; count; count--, e++){
+        if(!(*e & RT_DIR24_8_VALID) || rt_dir24_8_depth(*e) <= plen)
+            RT_STORE_RELEASE(*e, new_e);
+    }
+}
+
+static void
+rt_dir24_8_tbl8_replace(rt_dir24_8_t *dir, uint32_t group, uint32_t start,
+                        uint32_t count, uint32_t old_e, uint32_t new_e){
+
+    uint32_t *e = &dir->tbl8[group * RT_DIR24_8_GROUP_SIZE + start];
+
+    for(; count; count--, e++){
+        if(*e == old_e)
+            RT_STORE(*e, new_e);
+    }
+}
+
+/*Give back the tbl8 group of tbl24 entry i if no prefix longer than /24
+ * is left in it*/
+static void
+rt_dir24_8_tbl8_try_free(rt_dir24_8_t *dir, uint32_t i){
+
+    uint32_t group = dir->tbl24[i] & RT_DIR24_8_IDX_MASK;
+    uint32_t *e = &dir->tbl8[group * RT_DIR24_8_GROUP_SIZE];
+    uint32_t j;
+
+    if(rt_dir24_8_depth(e[0]) > 24)
+        return;
+
+    for(j = 1; j < RT_DIR24_8_GROUP_SIZE; j++){
+        if(e[j] != e[0])
+            return;
+    }
+
+    RT_STORE(dir->tbl24[i], e[0]);
+    dir->free_groups[dir->n_free_groups++] = group;
+}
+
+rt_bool_t
+rt_dir24_8_add(rt_dir24_8_t *dir, uint32_t key, uint8_t plen,
+               void *data, uint32_t *nh_idx){
+
+    uint32_t i, end, idx, new_e, e, group;
+
+    if(plen > RT_IPV4_MAX_MASK)
+        return RT_FALSE;
+
+    key &= rt_ipv4_mask(plen);
+
+    idx = rt_dir24_8_nh_alloc(dir, data);
+    if(idx == RT_DIR24_8_INVALID_IDX)
+        return RT_FALSE;
+
+    new_e = rt_dir24_8_entry(idx, plen);
+
+    if(plen <= 24){
+
+        end = (key >> 8) + (1U << (24 - plen));
+
+        for(i = key >> 8; i < end; i++){
+
+            e = dir->tbl24[i];
+
+            if(e & RT_DIR24_8_EXT)
+                rt_dir24_8_tbl8_set(dir, e & RT_DIR24_8_IDX_MASK, 0,
+                    RT_DIR24_8_GROUP_SIZE, new_e, plen);
+            else if(!(e & RT_DIR24_8_VALID) || rt_dir24_8_depth(e) <= plen)
+                RT_STORE_RELEASE(dir->tbl24[i], new_e);
+        }
+        *nh_idx = idx;
+        return RT_TRUE;
+    }
+
+    i = key >> 8;
+    e = dir->tbl24[i];
+
+    if(!(e & RT_DIR24_8_EXT)){
+
+        group = rt_dir24_8_slot_pop(dir->free_groups, &dir->n_free_groups,
+                    &dir->n_safe_groups, RT_TRUE);
+
+        if(group == RT_DIR24_8_INVALID_IDX){
+            rt_dir24_8_nh_free(dir, idx);
+            return RT_FALSE;
+        }
+
+        /*The new group inherits whatever the /24 resolved to so far*/
+        for(end = 0; end < RT_DIR24_8_GROUP_SIZE; end++)
+            dir->tbl8[group * RT_DIR24_8_GROUP_SIZE + end] = e;
+        RT_STORE_RELEASE(dir->tbl24[i], RT_DIR24_8_VALID | RT_DIR24_8_EXT | group);
+    }
+
+    rt_dir24_8_tbl8_set(dir, dir->tbl24[i] & RT_DIR24_8_IDX_MASK,
+        key & 0xFF, 1U << (RT_IPV4_MAX_MASK - plen), new_e, plen);
+    *nh_idx = idx;
+    return RT_TRUE;
+}
+
+void
+rt_dir24_8_delete(rt_dir24_8_t *dir, uint32_t key, uint8_t plen,
+                  uint32_t nh_idx, uint32_t rep_nh_idx, uint8_t rep_plen){
+
+    uint32_t i, end, e;
+    uint32_t old_e = rt_dir24_8_entry(nh_idx, plen);
+    uint32_t rep_e = rep_nh_idx == RT_DIR24_8_INVALID_IDX ? 0 :
+                        rt_dir24_8_entry(rep_nh_idx, rep_plen);
+
+    key &= rt_ipv4_mask(plen);
+
+    if(plen <= 24){
+
+        end = (key >> 8) + (1U << (24 - plen));
+
+        for(i = key >> 8; i < end; i++){
+
+            e = dir->tbl24[i];
+
+            if(e & RT_DIR24_8_EXT){
+                rt_dir24_8_tbl8_replace(dir, e & RT_DIR24_8_IDX_MASK, 0,
+                    RT_DIR24_8_GROUP_SIZE, old_e, rep_e);
+                rt_dir24_8_tbl8_try_free(dir, i);
+            }
+            else if(e == old_e)
+                RT_STORE(dir->tbl24[i], rep_e);
+        }
+    }
+    else{
+        i = key >> 8;
+        e = dir->tbl24[i];
+
+        if(e & RT_DIR24_8_EXT){
+            rt_dir24_8_tbl8_replace(dir, e & RT_DIR24_8_IDX_MASK, key & 0xFF,
+                1U << (RT_IPV4_MAX_MASK - plen), old_e, rep_e);
+            rt_dir24_8_tbl8_try_free(dir, i);
+        }
+    }
+
+    rt_dir24_8_nh_free(dir, nh_idx);
+}
+
+void
+rt_dir24_8_lookup_batch(rt_dir24_8_t *dir, const uint32_t *addrs,
+                        void **results, uint32_t n){
+
+    uint32_t entries[RT_LOOKUP_GROUP];
+    uint32_t base, n_group, i, e;
+    void **nh_tbl;
+
+    for(base = 0; base < n; base += RT_LOOKUP_GROUP){
+
+        n_group = n - base < RT_LOOKUP_GROUP ? n - base : RT_LOOKUP_GROUP;
+
+        for(i = 0; i < n_group; i++)
+            RT_PREFETCH(&dir->tbl24[addrs[base + i] >> 8]);
+
+        for(i = 0; i < n_group; i++){
+            e = RT_LOAD(dir->tbl24[addrs[base + i] >> 8]);
+            if(e & RT_DIR24_8_EXT)
+                RT_PREFETCH(&dir->tbl8[((e & RT_DIR24_8_IDX_MASK) * RT_DIR24_8_GROUP_SIZE) +
+                    (addrs[base + i] & 0xFF)]);
+            entries[i] = e;
+        }
+
+        for(i = 0; i < n_group; i++){
+            e = entries[i];
+            if(e & RT_DIR24_8_EXT)
+                entries[i] = RT_LOAD(dir->tbl8[((e & RT_DIR24_8_IDX_MASK) *
+                                RT_DIR24_8_GROUP_SIZE) + (addrs[base + i] & 0xFF)]);
+        }
+
+        /*Only once the entries are read, as rt_dir24_8_lookup() does, the
+         * next hop table may have grown for them*/
+        nh_tbl = RT_DEREF(dir->nh_tbl);
+
+        for(i = 0; i < n_group; i++){
+            if(entries[i] & RT_DIR24_8_VALID)
+                RT_PREFETCH(&nh_tbl[entries[i] & RT_DIR24_8_IDX_MASK]);
+        }
+
+        for(i = 0; i < n_group; i++){
+            e = entries[i];
+            results[base + i] = (e & RT_DIR24_8_VALID) ?
+                RT_LOAD(nh_tbl[e & RT_DIR24_8_IDX_MASK]) : NULL;
+        }
+    }
+}
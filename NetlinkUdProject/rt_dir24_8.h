@@ -0,0 +1,128 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_dir24_8.h
+ *
+ *    Description:  DIR-24-8 compiled lookup table for IPV4 routing tables
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 11:02:27 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_DIR24_8__
+#define __RT_DIR24_8__
+
+#include "rt_common.h"
+
+/* DIR-24-8 lookup table (Gupta, Lin, McKeown).
+ * tbl24 has one 32 bit entry for every /24, a prefix longer than /24
+ * makes its tbl24 entry point to a group of 256 tbl8 entries which
+ * resolve the last octet. Hence, any lookup completes in at most two
+ * memory accesses into the tables.
+ *
+ * Entry format : 
+ * +-------+-----+----------+-------------------------------+
+ * | VALID | EXT | DEPTH(6) |   NH index / tbl8 group (24)  |
+ * +-------+-----+----------+-------------------------------+
+ *
+ * DEPTH is the prefix length which programmed the entry, and lets a
+ * prefix be added or deleted incrementally without a rebuild*/
+
+#define RT_DIR24_8_VALID         (1U << 31)
+#define RT_DIR24_8_EXT           (1U << 30)
+#define RT_DIR24_8_DEPTH_SHIFT   24
+#define RT_DIR24_8_DEPTH_MASK    (0x3FU << RT_DIR24_8_DEPTH_SHIFT)
+#define RT_DIR24_8_IDX_MASK      0x00FFFFFFU
+
+#define RT_DIR24_8_TBL24_SIZE    (1U << 24)
+#define RT_DIR24_8_GROUP_SIZE    256
+#define RT_DIR24_8_DEF_TBL8_GROUPS  4096
+#define RT_DIR24_8_INVALID_IDX   RT_DIR24_8_IDX_MASK
+
+typedef struct rt_dir24_8_{
+
+    uint32_t *tbl24;
+    uint32_t *tbl8;
+    uint32_t n_tbl8_groups;
+    /* Stack of free tbl8 groups. The ones at n_safe_groups and above were
+     * freed after the last RT_SYNCHRONIZE(), lookups may still read them*/
+    uint32_t *free_groups;
+    uint32_t n_free_groups;
+    uint32_t n_safe_groups;
+    /*Next hop table, tbl entries store an index into it*/
+    void **nh_tbl;
+    uint32_t nh_capacity;
+    uint32_t nh_next;
+    /*Stack of recycled nh indexes, split like free_groups*/
+    uint32_t *free_nh;
+    uint32_t n_free_nh;
+    uint32_t n_safe_nh;
+    /*RT_TRUE if the tables are backed by huge pages*/
+    rt_bool_t huge_pages;
+} rt_dir24_8_t;
+
+/*Returns NULL on allocation failure. tbl8_groups = 0 picks the default*/
+rt_dir24_8_t *
+rt_dir24_8_create(uint32_t tbl8_groups);
+
+void
+rt_dir24_8_destroy(rt_dir24_8_t *dir);
+
+/* Programs key/plen, *nh_idx returns the next hop index assigned to
+ * data which the caller must hand back in rt_dir24_8_delete().
+ * Returns RT_FALSE if out of tbl8 groups or memory*/
+rt_bool_t
+rt_dir24_8_add(rt_dir24_8_t *dir, uint32_t key, uint8_t plen,
+               void *data, uint32_t *nh_idx);
+
+/* Removes key/plen which was programmed with nh_idx. The addresses it
+ * covered fall back to the covering prefix rep_plen programmed with
+ * rep_nh_idx, pass RT_DIR24_8_INVALID_IDX if there is none*/
+void
+rt_dir24_8_delete(rt_dir24_8_t *dir, uint32_t key, uint8_t plen,
+                  uint32_t nh_idx, uint32_t rep_nh_idx, uint8_t rep_plen);
+
+/* May run concurrently with the writer. Entries are stored with release
+ * semantics once the group/next hop they refer to is in place, and each
+ * load below depends on the address read by the previous one*/
+static inline void *
+rt_dir24_8_lookup(rt_dir24_8_t *dir, uint32_t addr){
+
+    uint32_t e = RT_LOAD(dir->tbl24[addr >> 8]);
+
+    if(e & RT_DIR24_8_EXT)
+        e = RT_LOAD(dir->tbl8[((e & RT_DIR24_8_IDX_MASK) * RT_DIR24_8_GROUP_SIZE) +
+                (addr & 0xFF)]);
+
+    if(!(e & RT_DIR24_8_VALID))
+        return NULL;
+
+    return RT_LOAD(RT_DEREF(dir->nh_tbl)[e & RT_DIR24_8_IDX_MASK]);
+}
+
+/* rt_dir24_8_lookup() of the n addrs, each stage prefetches what the
+ * next one reads for all the addrs of a group before reading any*/
+void
+rt_dir24_8_lookup_batch(rt_dir24_8_t *dir, const uint32_t *addrs,
+                        void **results, uint32_t n);
+
+#endif /* __RT_DIR24_8__ */
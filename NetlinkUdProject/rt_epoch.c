@@ -0,0 +1,233 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_epoch.c
+ *
+ *    Description:  Epoch based memory reclamation for user space rt tables
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 02:15:43 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "rt_epoch.h"
+
+#define RT_EPOCH_LIMBO_MIN  64
+
+/*Starts at 1, a record holding 0 is not in a read side section*/
+uint64_t rt_epoch_global = 1;
+__thread rt_epoch_record_t *rt_epoch_self;
+
+static __thread rt_epoch_limbo_t *rt_epoch_limbo_self;
+/*Records are never freed, only handed over to other threads*/
+static rt_epoch_record_t *rt_epoch_records;
+
+rt_epoch_record_t *
+rt_epoch_thread_online(void){
+
+    rt_epoch_record_t *rec;
+    uint32_t expected;
+
+    for(rec = __atomic_load_n(&rt_epoch_records, __ATOMIC_ACQUIRE);
+            rec; rec = rec->next){
+
+        expected = 0;
+        if(__atomic_compare_exchange_n(&rec->in_use, &expected, 1, 0,
+                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)){
+            rt_epoch_self = rec;
+            return rec;
+        }
+    }
+
+    rec = aligned_alloc(RT_EPOCH_CACHE_LINE, sizeof(rt_epoch_record_t));
+
+    /*There is no way to report it from rt_epoch_read_lock()*/
+    if(!rec)
+        abort();
+
+    memset(rec, 0, sizeof(rt_epoch_record_t));
+    rec->in_use = 1;
+    rec->next = __atomic_load_n(&rt_epoch_records, __ATOMIC_RELAXED);
+
+    do{
+        rec->id = rec->next ? rec->next->id + 1 : 0;
+    } while(!__atomic_compare_exchange_n(&rt_epoch_records, &rec->next, rec, 0,
+                __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    rt_epoch_self = rec;
+    return rec;
+}
+
+void
+rt_epoch_thread_offline(void){
+
+    rt_epoch_record_t *rec = rt_epoch_self;
+
+    if(!rec)
+        return;
+
+    rec->nesting = 0;
+    __atomic_store_n(&rec->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&rec->in_use, 0, __ATOMIC_RELEASE);
+    rt_epoch_self = NULL;
+}
+
+/* Oldest epoch a reader in flight has observed, the current one if
+ * there is no reader. What was retired before it is unreachable*/
+static uint64_t
+rt_epoch_min_active(void){
+
+    rt_epoch_record_t *rec;
+    uint64_t e, min;
+
+    /*Pairs with the fence in rt_epoch_read_lock()*/
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    min = __atomic_load_n(&rt_epoch_global, __ATOMIC_RELAXED);
+
+    for(rec = __atomic_load_n(&rt_epoch_records, __ATOMIC_ACQUIRE);
+            rec; rec = rec->next){
+
+        e = __atomic_load_n(&rec->epoch, __ATOMIC_ACQUIRE);
+        if(e && e < min)
+            min = e;
+    }
+    return min;
+}
+
+/*Must not be called from inside a read side section*/
+void
+rt_epoch_synchronize(void){
+
+    rt_epoch_record_t *rec;
+    uint64_t e, target;
+
+    target = __atomic_add_fetch(&rt_epoch_global, 1, __ATOMIC_SEQ_CST);
+
+    for(rec = __atomic_load_n(&rt_epoch_records, __ATOMIC_ACQUIRE);
+            rec; rec = rec->next){
+
+        while((e = __atomic_load_n(&rec->epoch, __ATOMIC_ACQUIRE)) && e < target)
+            sched_yield();
+    }
+}
+
+void
+rt_epoch_limbo_init(rt_epoch_limbo_t *limbo){
+
+    memset(limbo, 0, sizeof(rt_epoch_limbo_t));
+}
+
+void
+rt_epoch_limbo_destroy(rt_epoch_limbo_t *limbo){
+
+    uint32_t i;
+
+    if(limbo->n_items)
+        rt_epoch_synchronize();
+
+    for(i = 0; i < limbo->n_items; i++)
+        limbo->items[i].free_fn(limbo->items[i].arg, limbo->items[i].ptr);
+
+    free(limbo->items);
+    rt_epoch_limbo_init(limbo);
+}
+
+void
+rt_epoch_retire(rt_epoch_limbo_t *limbo, void *ptr,
+                rt_epoch_free_fn free_fn, void *arg){
+
+    rt_epoch_deferred_t *items;
+    uint32_t capacity;
+
+    if(!ptr)
+        return;
+
+    if(!limbo)
+        limbo = rt_epoch_limbo_self;
+
+    if(limbo && limbo->n_items == limbo->capacity){
+
+        capacity = limbo->capacity ? limbo->capacity * 2 : RT_EPOCH_LIMBO_MIN;
+        items = realloc(limbo->items, capacity * sizeof(rt_epoch_deferred_t));
+
+        if(items){
+            limbo->items = items;
+            limbo->capacity = capacity;
+        }
+    }
+
+    if(!limbo || limbo->n_items == limbo->capacity){
+        rt_epoch_synchronize();
+        free_fn(arg, ptr);
+        return;
+    }
+
+    /*ptr is unlinked already, readers which observe a later epoch can
+     * not reach it*/
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    items = &limbo->items[limbo->n_items++];
+    items->ptr = ptr;
+    items->free_fn = free_fn;
+    items->arg = arg;
+    items->epoch = __atomic_load_n(&rt_epoch_global, __ATOMIC_RELAXED);
+}
+
+void
+rt_epoch_reclaim(rt_epoch_limbo_t *limbo){
+
+    uint32_t i, n = 0;
+    uint64_t min;
+    rt_epoch_deferred_t *item;
+
+    if(!limbo->n_items)
+        return;
+
+    /*Readers entering from now on get a later epoch than all the items*/
+    __atomic_add_fetch(&rt_epoch_global, 1, __ATOMIC_SEQ_CST);
+    min = rt_epoch_min_active();
+
+    for(i = 0; i < limbo->n_items; i++){
+
+        item = &limbo->items[i];
+
+        if(item->epoch < min)
+            item->free_fn(item->arg, item->ptr);
+        else
+            limbo->items[n++] = *item;
+    }
+    limbo->n_items = n;
+}
+
+void
+rt_epoch_set_limbo(rt_epoch_limbo_t *limbo){
+
+    rt_epoch_limbo_self = limbo;
+}
+
+void
+rt_epoch_free(void *arg, void *ptr){
+
+    (void)arg;
+    free(ptr);
+}
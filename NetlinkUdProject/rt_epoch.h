@@ -0,0 +1,150 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_epoch.h
+ *
+ *    Description:  Epoch based memory reclamation for user space rt tables
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 02:15:43 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_EPOCH__
+#define __RT_EPOCH__
+
+#include <stdint.h>
+
+/* User space counterpart of RCU, which the shared rt code relies on
+ * through RT_FREE_DEFERRED()/RT_SYNCHRONIZE() (see rt_common.h).
+ *
+ * A global epoch counter is bumped by the writers. A reader thread
+ * records the epoch it observed when entering a read side section and
+ * clears it when leaving, which are two stores to a cache line of its
+ * own : readers never wait, never write shared data and take no lock.
+ * Memory a writer unlinks is tagged with the epoch at that time, it is
+ * freed once no reader is left in a section entered at that epoch or
+ * before. Retired memory is queued in a limbo list owned by a writer,
+ * typically the one of the table it belongs to, so there is no global
+ * lock on the writers' side either*/
+
+#define RT_EPOCH_CACHE_LINE     64
+
+typedef struct rt_epoch_record_{
+
+    /*Epoch observed when entering the read side section, 0 outside*/
+    uint64_t epoch;
+    uint32_t nesting;
+    uint32_t in_use;
+    struct rt_epoch_record_ *next;
+    /*Records are numbered from 0 in the order they are created, a thread
+     * keeps the number of the record it holds while online*/
+    uint32_t id;
+} __attribute__((aligned(RT_EPOCH_CACHE_LINE))) rt_epoch_record_t;
+
+typedef void (*rt_epoch_free_fn)(void *arg, void *ptr);
+
+typedef struct rt_epoch_deferred_{
+
+    void *ptr;
+    rt_epoch_free_fn free_fn;
+    void *arg;
+    uint64_t epoch;
+} rt_epoch_deferred_t;
+
+typedef struct rt_epoch_limbo_{
+
+    rt_epoch_deferred_t *items;
+    uint32_t n_items;
+    uint32_t capacity;
+} rt_epoch_limbo_t;
+
+extern uint64_t rt_epoch_global;
+extern __thread rt_epoch_record_t *rt_epoch_self;
+
+/*Registers the calling thread, done on its first read side section*/
+rt_epoch_record_t *
+rt_epoch_thread_online(void);
+
+/*A thread which is done with lookups may give back its record*/
+void
+rt_epoch_thread_offline(void);
+
+/*Read side sections nest, like rcu_read_lock()*/
+static inline void
+rt_epoch_read_lock(void){
+
+    rt_epoch_record_t *rec = rt_epoch_self;
+
+    if(!rec)
+        rec = rt_epoch_thread_online();
+
+    if(rec->nesting++)
+        return;
+
+    __atomic_store_n(&rec->epoch,
+        __atomic_load_n(&rt_epoch_global, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    /*The writers must see the epoch before any load of the section*/
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void
+rt_epoch_read_unlock(void){
+
+    rt_epoch_record_t *rec = rt_epoch_self;
+
+    if(--rec->nesting)
+        return;
+
+    __atomic_store_n(&rec->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/*Waits until all the read side sections in flight are over*/
+void
+rt_epoch_synchronize(void);
+
+void
+rt_epoch_limbo_init(rt_epoch_limbo_t *limbo);
+
+/*Waits for the readers and frees everything left in limbo*/
+void
+rt_epoch_limbo_destroy(rt_epoch_limbo_t *limbo);
+
+/* Queues ptr in limbo to be freed by free_fn(arg, ptr) once the readers
+ * are done with it. A NULL limbo stands for the one the calling thread
+ * selected with rt_epoch_set_limbo(), and if there is none, or no memory
+ * to queue ptr, the call waits for the readers and frees ptr at once*/
+void
+rt_epoch_retire(rt_epoch_limbo_t *limbo, void *ptr,
+                rt_epoch_free_fn free_fn, void *arg);
+
+/*Frees what the readers are done with, without waiting*/
+void
+rt_epoch_reclaim(rt_epoch_limbo_t *limbo);
+
+void
+rt_epoch_set_limbo(rt_epoch_limbo_t *limbo);
+
+/*free_fn for memory from malloc()*/
+void
+rt_epoch_free(void *arg, void *ptr);
+
+#endif /* __RT_EPOCH__ */
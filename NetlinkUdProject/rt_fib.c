@@ -0,0 +1,389 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_fib.c
+ *
+ *    Description:  Immutable compiled snapshot of an rt table for lookups
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 04:10:08 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifdef __KERNEL__
+#include <linux/socket.h>   /*AF_INET6*/
+#else
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#endif
+#include "rt_fib.h"
+
+#define RT_FIB_ALIGN(x)     (((x) + 63) & ~((uint64_t)63))
+
+/*Trie of one family while it is being built*/
+typedef struct rt_fib_tbl_{
+
+    uint32_t *entries;
+    uint32_t n_chunks;      /*Root included*/
+    uint32_t capacity;      /*In entries*/
+} rt_fib_tbl_t;
+
+static inline uint64_t
+rt_fib_tbl_entries(uint32_t n_chunks){
+
+    return RT_FIB_ROOT_SIZE + ((uint64_t)(n_chunks - 1) * RT_FIB_CHUNK_SIZE);
+}
+
+static rt_bool_t
+rt_fib_tbl_init(rt_fib_tbl_t *tbl){
+
+    tbl->capacity = RT_FIB_ROOT_SIZE + (64 * RT_FIB_CHUNK_SIZE);
+    tbl->entries = RT_CALLOC_LARGE(tbl->capacity * sizeof(uint32_t));
+    tbl->n_chunks = 1;
+    return tbl->entries ? RT_TRUE : RT_FALSE;
+}
+
+/*Returns the number of the new chunk, all set to fill, 0 on failure*/
+static uint32_t
+rt_fib_tbl_new_chunk(rt_fib_tbl_t *tbl, uint32_t fill){
+
+    uint32_t *entries, *chunk, i;
+    uint64_t capacity;
+
+    if(tbl->n_chunks >= RT_FIB_CHILD - 1)
+        return 0;
+
+    if(rt_fib_tbl_entries(tbl->n_chunks + 1) > tbl->capacity){
+
+        capacity = (uint64_t)tbl->capacity * 2;
+        if(capacity > 0xFFFFFFFFU)
+            return 0;
+
+        entries = RT_CALLOC_LARGE(capacity * sizeof(uint32_t));
+        if(!entries)
+            return 0;
+
+        memcpy(entries, tbl->entries,
+            rt_fib_tbl_entries(tbl->n_chunks) * sizeof(uint32_t));
+        RT_FREE_LARGE(tbl->entries);
+        tbl->entries = entries;
+        tbl->capacity = capacity;
+    }
+
+    chunk = tbl->entries + rt_fib_tbl_entries(tbl->n_chunks);
+    for(i = 0; i < RT_FIB_CHUNK_SIZE; i++)
+        chunk[i] = fill;
+
+    return tbl->n_chunks++;
+}
+
+/* Routes must be inserted by increasing prefix length. A prefix then
+ * never expands over a child chunk, those only exist below longer
+ * prefixes, and simply overwrites the shorter prefixes it covers*/
+static rt_bool_t
+rt_fib_tbl_insert(rt_fib_tbl_t *tbl, const uint8_t *key, uint8_t plen,
+                  uint32_t value){
+
+    uint64_t off = 0;
+    uint32_t start = 0, stride = RT_FIB_ROOT_STRIDE;
+    uint32_t idx, n, i, e, c;
+
+    for(;;){
+
+        idx = start ? key[start / 8] : (((uint32_t)key[0] << 8) | key[1]);
+
+        if(plen <= start + stride){
+
+            n = 1U << (start + stride - plen);
+            idx &= ~(n - 1);
+            for(i = 0; i < n; i++)
+                tbl->entries[off + idx + i] = value;
+            return RT_TRUE;
+        }
+
+        e = tbl->entries[off + idx];
+
+        if(!(e & RT_FIB_CHILD)){
+            /*Push the shorter prefix down into the new chunk*/
+            c = rt_fib_tbl_new_chunk(tbl, e);
+            if(!c)
+                return RT_FALSE;
+            e = RT_FIB_CHILD | c;
+            tbl->entries[off + idx] = e;
+        }
+
+        off = rt_fib_tbl_entries(e & ~RT_FIB_CHILD);
+        start += stride;
+        stride = RT_FIB_STRIDE;
+    }
+}
+
+rt_fib_t *
+rt_fib_build(const rt_fib_result_t *routes, uint32_t n, uint64_t generation){
+
+    rt_fib_tbl_t tbl4, tbl6;
+    rt_fib_t *fib = NULL;
+    uint32_t count[RT_IPV6_MAX_MASK + 2];
+    uint32_t *order;
+    uint32_t i, n6 = 0;
+    uint64_t size, tbl4_size, tbl6_size = 0;
+
+    memset(&tbl6, 0, sizeof(tbl6));
+
+    if(n >= RT_FIB_CHILD)
+        return NULL;
+
+    order = RT_CALLOC_LARGE(((uint64_t)n + 1) * sizeof(uint32_t));
+    if(!order)
+        return NULL;
+
+    /*Counting sort by prefix length*/
+    memset(count, 0, sizeof(count));
+    for(i = 0; i < n; i++){
+        count[routes[i].mask + 1]++;
+        if(routes[i].family == AF_INET6)
+            n6++;
+    }
+    for(i = 1; i < RT_IPV6_MAX_MASK + 2; i++)
+        count[i] += count[i - 1];
+    for(i = 0; i < n; i++)
+        order[count[routes[i].mask]++] = i;
+
+    if(!rt_fib_tbl_init(&tbl4) || (n6 && !rt_fib_tbl_init(&tbl6)))
+        goto done;
+
+    for(i = 0; i < n; i++){
+
+        if(!rt_fib_tbl_insert(routes[order[i]].family == AF_INET6 ? &tbl6 : &tbl4,
+                routes[order[i]].dest_addr, routes[order[i]].mask, order[i] + 1))
+            goto done;
+    }
+
+    tbl4_size = rt_fib_tbl_entries(tbl4.n_chunks) * sizeof(uint32_t);
+    if(n6)
+        tbl6_size = rt_fib_tbl_entries(tbl6.n_chunks) * sizeof(uint32_t);
+
+    size = RT_FIB_ALIGN(sizeof(rt_fib_t)) + RT_FIB_ALIGN(tbl4_size) +
+           RT_FIB_ALIGN(tbl6_size) + ((uint64_t)n * sizeof(rt_fib_result_t));
+
+    fib = RT_CALLOC_LARGE(size);
+    if(!fib)
+        goto done;
+
+    fib->magic = RT_FIB_MAGIC;
+    fib->version = RT_FIB_VERSION;
+    fib->size = size;
+    fib->generation = generation;
+    fib->n_results = n;
+    fib->n_chunks4 = tbl4.n_chunks;
+    fib->n_chunks6 = n6 ? tbl6.n_chunks : 0;
+    fib->tbl4_off = RT_FIB_ALIGN(sizeof(rt_fib_t));
+    fib->tbl6_off = fib->tbl4_off + RT_FIB_ALIGN(tbl4_size);
+    fib->results_off = fib->tbl6_off + RT_FIB_ALIGN(tbl6_size);
+
+    memcpy((char *)fib + fib->tbl4_off, tbl4.entries, tbl4_size);
+    if(n6)
+        memcpy((char *)fib + fib->tbl6_off, tbl6.entries, tbl6_size);
+    memcpy((char *)fib + fib->results_off, routes, (uint64_t)n * sizeof(rt_fib_result_t));
+
+done:
+    RT_FREE_LARGE(tbl4.entries);
+    RT_FREE_LARGE(tbl6.entries);
+    RT_FREE_LARGE(order);
+    return fib;
+}
+
+void
+rt_fib_free(rt_fib_t *fib){
+
+    RT_FREE_LARGE(fib);
+}
+
+#ifndef __KERNEL__
+
+rt_bool_t
+rt_fib_save(const rt_fib_t *fib, const char *path){
+
+    int fd, err;
+    ssize_t rc = 0;
+    uint64_t done = 0;
+    size_t tmp_len = strlen(path) + sizeof(".tmp");
+    char *tmp_path = malloc(tmp_len);
+
+    if(!tmp_path)
+        return RT_FALSE;
+
+    /*Readers of path see the old snapshot or the new one, never a part*/
+    snprintf(tmp_path, tmp_len, "%s.tmp", path);
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(fd < 0){
+        free(tmp_path);
+        return RT_FALSE;
+    }
+
+    while(done < fib->size){
+        rc = write(fd, (const char *)fib + done, fib->size - done);
+        if(rc < 0 && errno == EINTR)
+            continue;
+        if(rc <= 0)
+            break;
+        done += rc;
+    }
+
+    err = done < fib->size ? (rc < 0 ? errno : EIO) : (fsync(fd) ? errno : 0);
+
+    if(close(fd) && !err)
+        err = errno;
+
+    if(!err && rename(tmp_path, path))
+        err = errno;
+
+    if(err)
+        unlink(tmp_path);
+
+    free(tmp_path);
+    errno = err;
+    return err ? RT_FALSE : RT_TRUE;
+}
+
+static rt_bool_t
+rt_fib_section_ok(const rt_fib_t *fib, uint64_t off, uint64_t len){
+
+    return (off % sizeof(uint64_t)) == 0 && off >= sizeof(rt_fib_t) &&
+            off <= fib->size && len <= fib->size - off ? RT_TRUE : RT_FALSE;
+}
+
+static uint64_t
+rt_fib_tbl_size(uint32_t n_chunks){
+
+    return rt_fib_tbl_entries(n_chunks) * sizeof(uint32_t);
+}
+
+/* Every entry of a trie must lead somewhere within the snapshot : a
+ * result which exists, or a chunk numbered after its own, as built, not
+ * reached before and deeper than the root by less than the address
+ * length, so that the lookups neither loop nor run out of address
+ * bytes. Chunks no entry reaches are not looked at. RT_FALSE with errno
+ * set otherwise*/
+static rt_bool_t
+rt_fib_tbl_ok(const rt_fib_t *fib, uint64_t tbl_off, uint32_t n_chunks,
+              uint32_t addr_bits){
+
+    const uint32_t *entries = (const uint32_t *)((const char *)fib + tbl_off);
+    uint32_t max_level = 1 + ((addr_bits - RT_FIB_ROOT_STRIDE) / RT_FIB_STRIDE);
+    uint64_t i, n_entries = rt_fib_tbl_entries(n_chunks);
+    uint32_t chunk, e, c;
+    uint8_t *levels = calloc(n_chunks, sizeof(uint8_t));
+    rt_bool_t ok = RT_TRUE;
+
+    if(!levels)
+        return RT_FALSE;
+
+    levels[0] = 1;
+
+    for(i = 0; ok && i < n_entries; i++){
+
+        chunk = i < RT_FIB_ROOT_SIZE ? 0 :
+                    1 + (uint32_t)((i - RT_FIB_ROOT_SIZE) / RT_FIB_CHUNK_SIZE);
+
+        if(!levels[chunk])
+            continue;
+
+        e = entries[i];
+
+        if(!(e & RT_FIB_CHILD)){
+            ok = e <= fib->n_results;
+            continue;
+        }
+
+        c = e & ~RT_FIB_CHILD;
+        ok = c > chunk && c < n_chunks && !levels[c] && levels[chunk] < max_level;
+        if(ok)
+            levels[c] = levels[chunk] + 1;
+    }
+
+    free(levels);
+    if(!ok)
+        errno = EINVAL;
+    return ok;
+}
+
+const rt_fib_t *
+rt_fib_map(const char *path){
+
+    int fd, err;
+    struct stat st;
+    rt_fib_t *fib;
+
+    fd = open(path, O_RDONLY);
+
+    if(fd < 0)
+        return NULL;
+
+    if(fstat(fd, &st) || (uint64_t)st.st_size < sizeof(rt_fib_t)){
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    fib = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(fib == MAP_FAILED)
+        return NULL;
+
+    if(fib->magic != RT_FIB_MAGIC || fib->version != RT_FIB_VERSION ||
+        fib->size != (uint64_t)st.st_size || !fib->n_chunks4 ||
+        !rt_fib_section_ok(fib, fib->tbl4_off, rt_fib_tbl_size(fib->n_chunks4)) ||
+        (fib->n_chunks6 &&
+         !rt_fib_section_ok(fib, fib->tbl6_off, rt_fib_tbl_size(fib->n_chunks6))) ||
+        !rt_fib_section_ok(fib, fib->results_off,
+            (uint64_t)fib->n_results * sizeof(rt_fib_result_t))){
+        munmap(fib, st.st_size);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if(!rt_fib_tbl_ok(fib, fib->tbl4_off, fib->n_chunks4, RT_IPV4_MAX_MASK) ||
+        (fib->n_chunks6 &&
+         !rt_fib_tbl_ok(fib, fib->tbl6_off, fib->n_chunks6, RT_IPV6_MAX_MASK))){
+        err = errno;
+        munmap(fib, st.st_size);
+        errno = err;
+        return NULL;
+    }
+
+    return fib;
+}
+
+void
+rt_fib_unmap(const rt_fib_t *fib){
+
+    munmap((void *)fib, fib->size);
+}
+
+#endif
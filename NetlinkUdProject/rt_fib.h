@@ -0,0 +1,166 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_fib.h
+ *
+ *    Description:  Immutable compiled snapshot of an rt table for lookups
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 04:10:08 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_FIB__
+#define __RT_FIB__
+
+#include "rt_common.h"
+
+/* A FIB snapshot is a frozen copy of the routes compiled into a single
+ * contiguous block without any pointer : a header, a multibit trie per
+ * family stored as arrays of 32 bit entries, and the route results. The
+ * trie is leaf pushed, its first level resolves 16 bits of the address
+ * and every other level 8 bits, hence an IPV4 lookup is at most three
+ * dependent loads. Being immutable, a snapshot is replaced as a whole
+ * with one pointer store and readers never see it change.
+ *
+ * Entry format :
+ * +-------+------------------------------------------------+
+ * | CHILD |  level chunk number if CHILD, else result + 1  |
+ * +-------+------------------------------------------------+
+ * 0 is no route*/
+
+#define RT_FIB_MAGIC            0x52544642U     /*"RTFB"*/
+#define RT_FIB_VERSION          1
+#define RT_FIB_ROOT_STRIDE      16
+#define RT_FIB_STRIDE           8
+#define RT_FIB_ROOT_SIZE        (1U << RT_FIB_ROOT_STRIDE)
+#define RT_FIB_CHUNK_SIZE       (1U << RT_FIB_STRIDE)
+#define RT_FIB_CHILD            (1U << 31)
+
+typedef struct rt_fib_result_{
+
+    uint8_t dest_addr[RT_IPV6_ADDR_LEN];    /*Masked, network byte order*/
+    uint8_t gw_addr[RT_IPV6_ADDR_LEN];      /*All zero if none*/
+    uint32_t ifindex;
+    uint8_t mask;
+    uint8_t family;
+    uint8_t gw_family;
+    uint8_t reserved;
+} rt_fib_result_t;
+
+/*All offsets are in bytes from the start of the header*/
+typedef struct rt_fib_{
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;              /*Of the whole snapshot*/
+    uint64_t generation;        /*Of the table when compiled*/
+    uint32_t n_results;
+    uint32_t n_chunks4;         /*Root included*/
+    uint32_t n_chunks6;         /*0 if there are no IPV6 routes*/
+    uint32_t reserved;
+    uint64_t tbl4_off;
+    uint64_t tbl6_off;
+    uint64_t results_off;
+} rt_fib_t;
+
+/* Compiles the n routes into a snapshot, the order of routes is the
+ * order of the results in it. Returns NULL on allocation failure. The
+ * snapshot is one RT_CALLOC_LARGE() block*/
+rt_fib_t *
+rt_fib_build(const rt_fib_result_t *routes, uint32_t n, uint64_t generation);
+
+void
+rt_fib_free(rt_fib_t *fib);
+
+#ifndef __KERNEL__
+/* A snapshot on disk is the block as is, so it is written in a single
+ * pass and mapped back as is. The header is in host byte order, a
+ * snapshot from a host of the other byte order fails the magic check*/
+
+/*Writes fib to path, atomically replacing it. RT_FALSE with errno set*/
+rt_bool_t
+rt_fib_save(const rt_fib_t *fib, const char *path);
+
+/* Maps the snapshot saved in path read only, NULL with errno set if it
+ * cannot be read or is not a snapshot of this version. Besides the
+ * header and the bounds of the sections, every trie entry is checked to
+ * keep the lookups within the snapshot, one pass over the tries, so a
+ * truncated or corrupt file is refused rather than read out of bounds.
+ * The results themselves are not checked*/
+const rt_fib_t *
+rt_fib_map(const char *path);
+
+void
+rt_fib_unmap(const rt_fib_t *fib);
+#endif
+
+static inline const uint32_t *
+rt_fib_chunk(const rt_fib_t *fib, uint64_t tbl_off, uint32_t e){
+
+    /*Chunk 0 is the root, the others follow it*/
+    return (const uint32_t *)((const char *)fib + tbl_off) +
+            RT_FIB_ROOT_SIZE + ((e & ~RT_FIB_CHILD) - 1) * RT_FIB_CHUNK_SIZE;
+}
+
+static inline const rt_fib_result_t *
+rt_fib_result(const rt_fib_t *fib, uint32_t e){
+
+    if(!e)
+        return NULL;
+    return (const rt_fib_result_t *)((const char *)fib + fib->results_off) + (e - 1);
+}
+
+/*Longest prefix match, addr in host byte order*/
+static inline const rt_fib_result_t *
+rt_fib_lookup(const rt_fib_t *fib, uint32_t addr){
+
+    uint32_t e = ((const uint32_t *)((const char *)fib + fib->tbl4_off))[addr >> 16];
+
+    if(e & RT_FIB_CHILD)
+        e = rt_fib_chunk(fib, fib->tbl4_off, e)[(addr >> 8) & 0xFF];
+
+    if(e & RT_FIB_CHILD)
+        e = rt_fib_chunk(fib, fib->tbl4_off, e)[addr & 0xFF];
+
+    return rt_fib_result(fib, e);
+}
+
+/*Longest prefix match, addr is 16 bytes in network byte order*/
+static inline const rt_fib_result_t *
+rt_fib_lookup6(const rt_fib_t *fib, const uint8_t *addr){
+
+    uint32_t i = 2, e;
+
+    /*No IPV6 routes*/
+    if(!fib->n_chunks6)
+        return NULL;
+
+    e = ((const uint32_t *)((const char *)fib + fib->tbl6_off))[
+            ((uint32_t)addr[0] << 8) | addr[1]];
+
+    while(e & RT_FIB_CHILD)
+        e = rt_fib_chunk(fib, fib->tbl6_off, e)[addr[i++]];
+
+    return rt_fib_result(fib, e);
+}
+
+#endif /* __RT_FIB__ */
@@ -0,0 +1,205 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_iface.c
+ *
+ *    Description:  Implementation of the interned names of the outgoing interfaces of the routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 06:12:40 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_iface.h"
+#ifdef __KERNEL__
+#include <linux/netdevice.h> /*dev_get_by_name*/
+#else
+#include <net/if.h>    /*if_nametoindex*/
+#endif
+
+#define RT_IFACE_MIN_CAPACITY   16
+
+/*FNV-1a, of the part of name that gets stored*/
+static inline uint32_t
+rt_iface_hash(const char *name){
+
+    uint32_t h = 2166136261U, i;
+
+    for(i = 0; i < RT_IF_NAME_LEN - 1 && name[i]; i++){
+        h ^= (uint8_t)name[i];
+        h *= 16777619U;
+    }
+    return h ^ (h >> 15);
+}
+
+static uint32_t
+rt_iface_resolve(const char *name){
+
+#ifdef __KERNEL__
+    uint32_t ifindex = 0;
+    struct net_device *dev;
+
+    if(!name[0])
+        return 0;
+
+    dev = dev_get_by_name(&init_net, name);
+
+    if(dev){
+        ifindex = dev->ifindex;
+        dev_put(dev);
+    }
+    return ifindex;
+#else
+    return name[0] ? if_nametoindex(name) : 0;
+#endif
+}
+
+static void
+rt_iface_hash_add(rt_iface_table_t *if_table, uint32_t if_id){
+
+    rt_iface_t *iface = &if_table->ifaces[if_id];
+    uint32_t *bucket = &if_table->buckets[
+            rt_iface_hash(iface->name) & (if_table->n_buckets - 1)];
+
+    iface->next_id = *bucket;
+    *bucket = if_id;
+}
+
+static void
+rt_iface_hash_remove(rt_iface_table_t *if_table, uint32_t if_id){
+
+    rt_iface_t *iface = &if_table->ifaces[if_id];
+    uint32_t *id = &if_table->buckets[
+            rt_iface_hash(iface->name) & (if_table->n_buckets - 1)];
+
+    for(; *id != RT_IFACE_INVALID_ID; id = &if_table->ifaces[*id].next_id){
+        if(*id == if_id){
+            *id = iface->next_id;
+            return;
+        }
+    }
+}
+
+/* Doubles the interface array and the hash buckets and rehashes. No
+ * lookup reads the array, it can go at once*/
+static rt_bool_t
+rt_iface_table_grow(rt_iface_table_t *if_table){
+
+    uint32_t new_capacity = if_table->capacity ?
+                if_table->capacity * 2 : RT_IFACE_MIN_CAPACITY;
+    rt_iface_t *ifaces = RT_CALLOC(new_capacity * sizeof(rt_iface_t));
+    uint32_t *buckets = RT_CALLOC(new_capacity * sizeof(uint32_t));
+    uint32_t id;
+
+    if(!ifaces || !buckets){
+        RT_FREE(ifaces);
+        RT_FREE(buckets);
+        return RT_FALSE;
+    }
+
+    if(if_table->capacity)
+        memcpy(ifaces, if_table->ifaces, if_table->capacity * sizeof(rt_iface_t));
+    RT_FREE(if_table->ifaces);
+    RT_FREE(if_table->buckets);
+
+    if_table->ifaces = ifaces;
+    if_table->buckets = buckets;
+    if_table->n_buckets = new_capacity;
+    if_table->capacity = new_capacity;
+
+    memset(buckets, 0xFF, new_capacity * sizeof(uint32_t));
+    for(id = 0; id < if_table->next_id; id++){
+        if(ifaces[id].ref_count)
+            rt_iface_hash_add(if_table, id);
+    }
+    return RT_TRUE;
+}
+
+void
+rt_iface_table_init(rt_iface_table_t *if_table){
+
+    memset(if_table, 0, sizeof(rt_iface_table_t));
+    if_table->free_id = RT_IFACE_INVALID_ID;
+}
+
+void
+rt_iface_table_destroy(rt_iface_table_t *if_table){
+
+    RT_FREE(if_table->ifaces);
+    RT_FREE(if_table->buckets);
+    rt_iface_table_init(if_table);
+}
+
+uint32_t
+rt_iface_get(rt_iface_table_t *if_table, const char *name){
+
+    uint32_t if_id;
+    rt_iface_t *iface;
+
+    if(if_table->n_buckets){
+
+        if_id = if_table->buckets[rt_iface_hash(name) & (if_table->n_buckets - 1)];
+
+        for(; if_id != RT_IFACE_INVALID_ID; if_id = iface->next_id){
+
+            iface = &if_table->ifaces[if_id];
+
+            if(strncmp(iface->name, name, sizeof(iface->name) - 1) == 0){
+                iface->ref_count++;
+                return if_id;
+            }
+        }
+    }
+
+    if(if_table->free_id != RT_IFACE_INVALID_ID){
+        if_id = if_table->free_id;
+        if_table->free_id = if_table->ifaces[if_id].next_id;
+    }
+    else{
+        if(if_table->next_id == if_table->capacity &&
+            !rt_iface_table_grow(if_table))
+            return RT_IFACE_INVALID_ID;
+        if_id = if_table->next_id++;
+    }
+
+    iface = &if_table->ifaces[if_id];
+    memset(iface->name, 0, sizeof(iface->name));
+    strncpy(iface->name, name, sizeof(iface->name) - 1);
+    iface->ifindex = rt_iface_resolve(iface->name);
+    iface->ref_count = 1;
+    rt_iface_hash_add(if_table, if_id);
+    if_table->n_ifaces++;
+    return if_id;
+}
+
+void
+rt_iface_put(rt_iface_table_t *if_table, uint32_t if_id){
+
+    rt_iface_t *iface = &if_table->ifaces[if_id];
+
+    if(--iface->ref_count)
+        return;
+
+    rt_iface_hash_remove(if_table, if_id);
+    iface->next_id = if_table->free_id;
+    if_table->free_id = if_id;
+    if_table->n_ifaces--;
+}
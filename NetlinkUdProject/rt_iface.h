@@ -0,0 +1,85 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_iface.h
+ *
+ *    Description:  Interned names of the outgoing interfaces of the routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 06:12:40 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_IFACE__
+#define __RT_IFACE__
+
+#include "rt_common.h"
+
+/* The routes of a table go out of a handful of interfaces. Their names
+ * are interned here, each one getting a small id, so that next hops
+ * store, hash and compare 32 bit ids instead of names. The ifindex of a
+ * name is resolved once, when it is interned. Only writers use this
+ * table, lookups read the ifindex copied into the next hops*/
+
+#define RT_IFACE_INVALID_ID     0xFFFFFFFFU
+
+typedef struct rt_iface_{
+
+    char name[RT_IF_NAME_LEN];
+    uint32_t ifindex;       /*0 if there was no such interface*/
+    uint32_t ref_count;
+    /*Next id in the same hash bucket, or next free id if unused*/
+    uint32_t next_id;
+} rt_iface_t;
+
+typedef struct rt_iface_table_{
+
+    rt_iface_t *ifaces;     /*Indexed by id*/
+    uint32_t capacity;
+    uint32_t next_id;       /*Ids below this have been handed out once*/
+    uint32_t free_id;       /*Head of the list of recycled ids*/
+    uint32_t n_ifaces;
+    uint32_t *buckets;
+    uint32_t n_buckets;     /*Power of 2*/
+} rt_iface_table_t;
+
+void
+rt_iface_table_init(rt_iface_table_t *if_table);
+
+void
+rt_iface_table_destroy(rt_iface_table_t *if_table);
+
+/* Returns the id of the interface named name, interning it if needed,
+ * and takes a reference on it. RT_IFACE_INVALID_ID on alloc failure*/
+uint32_t
+rt_iface_get(rt_iface_table_t *if_table, const char *name);
+
+/*Drops a reference taken by rt_iface_get()*/
+void
+rt_iface_put(rt_iface_table_t *if_table, uint32_t if_id);
+
+static inline rt_iface_t *
+rt_iface_lookup(rt_iface_table_t *if_table, uint32_t if_id){
+
+    return &if_table->ifaces[if_id];
+}
+
+#endif /* __RT_IFACE__ */
@@ -0,0 +1,235 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_interval.c
+ *
+ *    Description:  Interval array engine in Eytzinger order for static IPV4 routing tables
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 06:40:12 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_interval.h"
+
+/*A prefix of the build, sorted by key then shortest first*/
+typedef struct rt_interval_prefix_{
+
+    uint32_t key;
+    uint32_t plen;
+    void *data;
+} rt_interval_prefix_t;
+
+/*Intervals in address order while building, by their first address*/
+typedef struct rt_interval_list_{
+
+    uint32_t n;
+    uint32_t *starts;
+    void **data;
+} rt_interval_list_t;
+
+static int
+rt_interval_prefix_cmp(const void *a, const void *b){
+
+    const rt_interval_prefix_t *p1 = a, *p2 = b;
+
+    if(p1->key != p2->key)
+        return p1->key < p2->key ? -1 : 1;
+    return (int)p1->plen - (int)p2->plen;
+}
+
+/* data from start on, overriding an interval starting there too and
+ * merging with the previous interval when going to the same place*/
+static void
+rt_interval_emit(rt_interval_list_t *list, uint32_t start, void *data){
+
+    uint32_t n = list->n;
+
+    if(n && list->starts[n - 1] == start){
+        list->data[n - 1] = data;
+        if(n > 1 && list->data[n - 2] == data)
+            list->n--;
+        return;
+    }
+
+    if(n && list->data[n - 1] == data)
+        return;
+
+    list->starts[n] = start;
+    list->data[n] = data;
+    list->n++;
+}
+
+/* Sweeps the sorted prefixes with the stack of those enclosing the
+ * current one, innermost on top*/
+static void
+rt_interval_sweep(const rt_interval_prefix_t *prefixes, uint32_t n,
+                  rt_interval_list_t *list){
+
+    uint32_t stack_end[RT_IPV4_MAX_MASK + 1];
+    void *stack_data[RT_IPV4_MAX_MASK + 1];
+    uint32_t top = 0, i, end;
+
+    rt_interval_emit(list, 0, NULL);
+
+    for(i = 0; i < n; i++){
+
+        /*Back to the enclosing prefix after the ones over before key*/
+        while(top && stack_end[top - 1] < prefixes[i].key){
+            end = stack_end[--top];
+            rt_interval_emit(list, end + 1, top ? stack_data[top - 1] : NULL);
+        }
+
+        rt_interval_emit(list, prefixes[i].key, prefixes[i].data);
+        stack_end[top] = prefixes[i].key | ~rt_ipv4_mask(prefixes[i].plen);
+        stack_data[top++] = prefixes[i].data;
+    }
+
+    while(top){
+        end = stack_end[--top];
+        /*Those up to the last address enclose each other*/
+        if(end == 0xFFFFFFFF)
+            break;
+        rt_interval_emit(list, end + 1, top ? stack_data[top - 1] : NULL);
+    }
+}
+
+/*In order walk of the tree at k filling it with the sorted intervals from i*/
+static uint32_t
+rt_interval_layout(rt_interval_t *interval, const rt_interval_list_t *list,
+                   uint32_t i, unsigned long k){
+
+    if(k >= (1UL << interval->depth))
+        return i;
+
+    i = rt_interval_layout(interval, list, i, 2 * k);
+
+    /*The padding goes last in address order, never first of the ends >= addr*/
+    if(i < list->n){
+        interval->ends[k] = (i + 1 < list->n) ? list->starts[i + 1] - 1 : 0xFFFFFFFF;
+        interval->data[k] = list->data[i];
+    } else {
+        interval->ends[k] = 0xFFFFFFFF;
+    }
+
+    return rt_interval_layout(interval, list, i + 1, (2 * k) + 1);
+}
+
+static rt_interval_t *
+rt_interval_alloc(uint32_t n){
+
+    rt_interval_t *interval;
+    uint32_t depth = 0;
+    uint64_t n_slots;
+
+    while(((1ULL << depth) - 1) < n)
+        depth++;
+
+    /*Slot 0 unused, room to align the ends*/
+    n_slots = 1ULL << depth;
+    interval = RT_CALLOC_LARGE(sizeof(rt_interval_t) + RT_INTERVAL_LINE +
+                    (n_slots * (sizeof(uint32_t) + sizeof(void *))));
+
+    if(!interval)
+        return NULL;
+
+    interval->n = n;
+    interval->depth = depth;
+    interval->data = (void **)interval->block;
+    interval->ends = (uint32_t *)(((uintptr_t)(interval->data + n_slots) +
+                        RT_INTERVAL_LINE - 1) & ~(uintptr_t)(RT_INTERVAL_LINE - 1));
+    return interval;
+}
+
+rt_interval_t *
+rt_interval_build(const uint32_t *keys, const uint8_t *plens, void *const *data,
+                  uint32_t n){
+
+    rt_interval_prefix_t *prefixes;
+    rt_interval_list_t list;
+    rt_interval_t *interval = NULL;
+    uint32_t i;
+
+    prefixes = RT_CALLOC_LARGE(((uint64_t)n + 1) * sizeof(rt_interval_prefix_t));
+    list.n = 0;
+    list.starts = RT_CALLOC_LARGE(((2 * (uint64_t)n) + 1) * sizeof(uint32_t));
+    list.data = RT_CALLOC_LARGE(((2 * (uint64_t)n) + 1) * sizeof(void *));
+
+    if(!prefixes || !list.starts || !list.data)
+        goto out;
+
+    for(i = 0; i < n; i++){
+        prefixes[i].key = keys[i];
+        prefixes[i].plen = plens[i];
+        prefixes[i].data = data[i];
+    }
+
+    RT_SORT(prefixes, n, sizeof(rt_interval_prefix_t), rt_interval_prefix_cmp);
+    rt_interval_sweep(prefixes, n, &list);
+
+    if((interval = rt_interval_alloc(list.n)))
+        rt_interval_layout(interval, &list, 0, 1);
+
+out:
+    if(prefixes)
+        RT_FREE_LARGE(prefixes);
+    if(list.starts)
+        RT_FREE_LARGE(list.starts);
+    if(list.data)
+        RT_FREE_LARGE(list.data);
+    return interval;
+}
+
+uint64_t
+rt_interval_mem_usage(const rt_interval_t *interval){
+
+    return sizeof(rt_interval_t) + RT_INTERVAL_LINE +
+           ((1ULL << interval->depth) * (sizeof(uint32_t) + sizeof(void *)));
+}
+
+void
+rt_interval_lookup_batch(const rt_interval_t *interval, const uint32_t *addrs,
+                         void **results, uint32_t n){
+
+    const uint32_t *ends = interval->ends;
+    unsigned long k[RT_LOOKUP_GROUP];
+    uint32_t base, n_group, level, i;
+
+    for(base = 0; base < n; base += RT_LOOKUP_GROUP){
+
+        n_group = n - base < RT_LOOKUP_GROUP ? n - base : RT_LOOKUP_GROUP;
+
+        for(i = 0; i < n_group; i++)
+            k[i] = 1;
+
+        /*All the lookups take depth steps, the next one of each prefetched*/
+        for(level = 0; level < interval->depth; level++){
+            for(i = 0; i < n_group; i++){
+                k[i] = (2 * k[i]) + (ends[k[i]] < addrs[base + i]);
+                if(level + 1 < interval->depth)
+                    RT_PREFETCH(&ends[k[i]]);
+            }
+        }
+
+        for(i = 0; i < n_group; i++)
+            results[base + i] = interval->data[k[i] >> __builtin_ffsl((long)~k[i])];
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_interval.h
+ *
+ *    Description:  Interval array engine in Eytzinger order for static IPV4 routing tables
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 06:40:12 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_INTERVAL__
+#define __RT_INTERVAL__
+
+#include "rt_common.h"
+
+/* Engine for IPV4 tables which seldom change. The prefixes cut the
+ * address space into disjoint intervals, each with the longest prefix
+ * covering it, or none. Only the last address of each interval is kept,
+ * sorted, the interval of an address being the first whose end is not
+ * below it. The ends are laid out in Eytzinger order, the children of
+ * slot k at 2k and 2k + 1, and padded up to a full tree with ends of
+ * 0xFFFFFFFF : a lookup is depth steps of k = 2k + (ends[k] < addr)
+ * with no branch on the address, the 16 descendants of k four levels
+ * down sharing the cache line prefetched at 16k.
+ *
+ * An rt_interval_t takes at most 2n + 1 intervals of 12 bytes (8 on 32
+ * bit machines) for n prefixes, before padding. It is immutable, a
+ * change of the routes means building it again*/
+
+#define RT_INTERVAL_LINE            64
+#define RT_INTERVAL_PREFETCH_LEVELS 4   /*16 ends per line*/
+
+typedef struct rt_interval_{
+
+    uint32_t n;                 /*Intervals*/
+    uint32_t depth;             /*Levels of the tree*/
+    /*Slots 1 to 2^depth - 1 in Eytzinger order, ends cache line aligned*/
+    uint32_t *ends;
+    void **data;
+    /*Both arrays*/
+    uint8_t block[];
+} rt_interval_t;
+
+/* Builds the engine out of n prefixes given in any order, keys in host
+ * byte order masked to plen, all different. NULL if out of memory*/
+rt_interval_t *
+rt_interval_build(const uint32_t *keys, const uint8_t *plens, void *const *data,
+                  uint32_t n);
+
+static inline void
+rt_interval_free(rt_interval_t *interval){
+
+    RT_FREE_LARGE(interval);
+}
+
+/*Bytes taken by interval*/
+uint64_t
+rt_interval_mem_usage(const rt_interval_t *interval);
+
+/*Longest prefix match, addr in host byte order*/
+static inline void *
+rt_interval_lookup(const rt_interval_t *interval, uint32_t addr){
+
+    const uint32_t *ends = interval->ends;
+    uint32_t depth = interval->depth, level = 0;
+    unsigned long k = 1;
+
+    for(; level + RT_INTERVAL_PREFETCH_LEVELS < depth; level++){
+        RT_PREFETCH(&ends[k << RT_INTERVAL_PREFETCH_LEVELS]);
+        k = (2 * k) + (ends[k] < addr);
+    }
+    for(; level < depth; level++)
+        k = (2 * k) + (ends[k] < addr);
+
+    /*Back up past the right turns to the last left one*/
+    k >>= __builtin_ffsl((long)~k);
+    return interval->data[k];
+}
+
+/*n lookups in lockstep, see RT_LOOKUP_GROUP*/
+void
+rt_interval_lookup_batch(const rt_interval_t *interval, const uint32_t *addrs,
+                         void **results, uint32_t n);
+
+#endif /* __RT_INTERVAL__ */
@@ -0,0 +1,109 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_journal.c
+ *
+ *    Description:  Implementation of the bounded journal of the changes of the routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 07:03:26 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_journal.h"
+
+#define RT_JOURNAL_MIN_RECS     64
+
+rt_journal_t *
+rt_journal_create(uint32_t n_recs, uint64_t generation){
+
+    uint32_t bits = 0;
+    rt_journal_t *journal;
+
+    if(n_recs < RT_JOURNAL_MIN_RECS)
+        n_recs = RT_JOURNAL_MIN_RECS;
+
+    while((1U << bits) < n_recs && bits < 31)
+        bits++;
+
+    journal = RT_CALLOC(sizeof(rt_journal_t));
+
+    if(!journal)
+        return NULL;
+
+    journal->recs = RT_CALLOC_LARGE((uint64_t)sizeof(rt_journal_rec_t) << bits);
+
+    if(!journal->recs){
+        RT_FREE(journal);
+        return NULL;
+    }
+
+    journal->n_recs = 1U << bits;
+    journal->lost_generation = generation;
+    return journal;
+}
+
+void
+rt_journal_destroy(rt_journal_t *journal){
+
+    if(!journal)
+        return;
+
+    RT_FREE_LARGE(journal->recs);
+    RT_FREE(journal);
+}
+
+rt_journal_rec_t *
+rt_journal_append(rt_journal_t *journal, uint64_t generation){
+
+    rt_journal_rec_t *rec = rt_journal_get(journal, journal->n_written);
+
+    /*The ring wraps over the oldest change*/
+    if(journal->n_written >= journal->n_recs)
+        journal->lost_generation = rec->generation;
+
+    journal->n_written++;
+    memset(rec, 0, sizeof(rt_journal_rec_t));
+    rec->generation = generation;
+    return rec;
+}
+
+rt_bool_t
+rt_journal_find(rt_journal_t *journal, uint64_t generation, uint64_t *seq){
+
+    uint64_t lo = journal->n_written > journal->n_recs ?
+                    journal->n_written - journal->n_recs : 0;
+    uint64_t hi = journal->n_written, mid;
+
+    if(generation < journal->lost_generation)
+        return RT_FALSE;
+
+    /*Generations only grow along the ring*/
+    while(lo < hi){
+        mid = lo + (hi - lo) / 2;
+        if(rt_journal_get(journal, mid)->generation <= generation)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    *seq = lo;
+    return RT_TRUE;
+}
@@ -0,0 +1,98 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_journal.h
+ *
+ *    Description:  Bounded journal of the changes of the routes of a routing table
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 07:03:26 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_JOURNAL__
+#define __RT_JOURNAL__
+
+#include "rt_common.h"
+
+/* Ring of the last changes of the routes, each tagged with the
+ * generation of the table it became visible at, so that a consumer
+ * which has seen the table at some generation catches up by reading
+ * the changes after it instead of walking all the routes. Changes made
+ * in one go, like a bulk load, share a generation. Once the ring wraps
+ * over changes a consumer has not seen, it has to start over from a
+ * full walk*/
+
+typedef enum{
+
+    RT_JOURNAL_ADD,
+    RT_JOURNAL_DELETE,
+    RT_JOURNAL_UPDATE,      /*Of the paths of the route*/
+    RT_JOURNAL_CLEAR        /*All the routes went away*/
+} rt_journal_op_t;
+
+typedef struct rt_journal_rec_{
+
+    uint64_t generation;
+    uint8_t dest_addr[RT_IPV6_ADDR_LEN];    /*Masked, network byte order*/
+    /*Of the route after the change, for ADD and UPDATE. The path of flow
+     * hash 0 for a multipath route, see rt_entry_nexthop()*/
+    uint8_t gw_addr[RT_IPV6_ADDR_LEN];      /*All zero if none*/
+    uint32_t ifindex;
+    uint8_t op;             /*rt_journal_op_t*/
+    uint8_t mask;
+    uint8_t family;
+    uint8_t gw_family;
+} rt_journal_rec_t;
+
+typedef struct rt_journal_{
+
+    rt_journal_rec_t *recs;
+    uint32_t n_recs;        /*Power of 2*/
+    uint64_t n_written;     /*Record n is in recs[n % n_recs]*/
+    /*Changes up to this generation may be missing from the ring*/
+    uint64_t lost_generation;
+} rt_journal_t;
+
+/* Journal of at least n_recs changes, of a table now at generation.
+ * NULL on alloc failure*/
+rt_journal_t *
+rt_journal_create(uint32_t n_recs, uint64_t generation);
+
+void
+rt_journal_destroy(rt_journal_t *journal);
+
+/*The record to fill for a change becoming visible at generation*/
+rt_journal_rec_t *
+rt_journal_append(rt_journal_t *journal, uint64_t generation);
+
+/* Sets seq to the first record of a change after generation, n_written
+ * if none. RT_FALSE if some of them were overwritten*/
+rt_bool_t
+rt_journal_find(rt_journal_t *journal, uint64_t generation, uint64_t *seq);
+
+static inline rt_journal_rec_t *
+rt_journal_get(rt_journal_t *journal, uint64_t seq){
+
+    return &journal->recs[seq & (journal->n_recs - 1)];
+}
+
+#endif /* __RT_JOURNAL__ */
@@ -29,93 +29,135 @@
  */
 
 #include "rt.h"
+#include "rt_platform.h"
 #include <linux/slab.h> /*kmalloc/kfree*/
+#include <linux/inet.h> /*in4_pton/in6_pton*/
 
-void
-rt_init_rt_table(rt_table_t *rt_table){
+rt_bool_t
+rt_ipv4_pton(char *ip, uint32_t *addr){
+
+    __be32 addr_n;
 
-    init_glthread(&rt_table->head);
+    if(in4_pton(ip, -1, (u8 *)&addr_n, -1, NULL) != 1)
+        return RT_FALSE;
+    *addr = ntohl(addr_n);
+    return RT_TRUE;
 }
 
 rt_bool_t
-rt_add_new_rt_entry(rt_table_t *rt_table,
-    char *dest_ip, char mask, char *gw_ip, char *oif){
+rt_ipv6_pton(char *ip, uint8_t *addr){
 
-    rt_entry_t *rt_entry = NULL;
+    return in6_pton(ip, -1, addr, -1, NULL) == 1 ? RT_TRUE : RT_FALSE;
+}
 
-    rt_entry = kmalloc(sizeof(rt_entry_t), GFP_KERNEL); 
+/*Text form of the gateway of nh, "" if none*/
+void
+rt_gw_ntop(rt_nexthop_t *nh, char *buf, uint32_t buf_len){
 
-    if(!rt_entry)
-        return RT_FALSE;
+    static const uint8_t none[RT_IPV6_ADDR_LEN];
 
-    strncpy(rt_entry->dest_ip, dest_ip, sizeof(rt_entry->dest_ip));
-    rt_entry->mask = mask;
-    strncpy(rt_entry->gw_ip, gw_ip, sizeof(rt_entry->gw_ip));
-    strncpy(rt_entry->oif, oif, sizeof(rt_entry->oif));
+    buf[0] = '\0';
 
-    init_glthread(&rt_entry->rt_entry_glue);
+    if(!memcmp(nh->gw_addr, none, sizeof(none)))
+        return;
 
-    glthread_add_next(&rt_table->head, &rt_entry->rt_entry_glue);
-    return RT_TRUE;
+    if(nh->family == AF_INET6)
+        snprintf(buf, buf_len, "%pI6c", nh->gw_addr);
+    else
+        snprintf(buf, buf_len, "%pI4", nh->gw_addr);
 }
 
-rt_bool_t
-rt_delete_rt_entry(rt_table_t *rt_table,
-    char *dest_ip, char mask){
-
-    glthread_t *curr;
-    rt_entry_t *rt_entry = NULL;
+void
+rt_log(const char *fmt, ...){
 
-    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
-    
-        rt_entry = rt_entry_glue_to_rt_entry(curr);
+    struct va_format vaf;
+    va_list args;
 
-        if(strncmp(rt_entry->dest_ip, dest_ip, sizeof(rt_entry->dest_ip)) == 0 &&
-            rt_entry->mask == mask){
+    va_start(args, fmt);
+    vaf.fmt = fmt;
+    vaf.va = &args;
+    printk(KERN_INFO "%pV", &vaf);
+    va_end(args);
+}
 
-            remove_glthread(&rt_entry->rt_entry_glue);
-            kfree(rt_entry);
-            return RT_TRUE;
-        }
-    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+void
+rt_table_lock(rt_table_t *rt_table){
 
-    return RT_FALSE;
+    mutex_lock(&rt_table->lock);
 }
 
-rt_bool_t
-rt_update_rt_entry(rt_table_t *rt_table,
-    char *dest_ip, char mask, 
-    char *new_gw_ip, char *new_oif){
+void
+rt_table_unlock(rt_table_t *rt_table){
 
-    return RT_TRUE;
+    mutex_unlock(&rt_table->lock);
 }
 
-void
-rt_clear_rt_table(rt_table_t *rt_table){
+static const struct rhashtable_params rt_prefix_hash_params4 = {
+
+    .head_offset = offsetof(rt_entry_t, rt_hash_node),
+    .key_offset = offsetof(rt_entry_t, dest_addr),
+    .key_len = sizeof(uint32_t),
+    .automatic_shrinking = true,
+};
+
+static const struct rhashtable_params rt_prefix_hash_params6 = {
+
+    .head_offset = offsetof(rt_entry_t, rt_hash_node),
+    .key_offset = offsetof(rt_entry_t, dest_addr),
+    .key_len = RT_IPV6_ADDR_LEN,
+    .automatic_shrinking = true,
+};
+
+#define RT_PREFIX_HASH_PARAMS(family)   \
+    ((family) == AF_INET ? rt_prefix_hash_params4 : rt_prefix_hash_params6)
 
+rt_prefix_hash_t *
+rt_prefix_hash_create(uint8_t family){
 
+    rt_prefix_hash_t *hash = kzalloc(sizeof(rt_prefix_hash_t), GFP_KERNEL);
+
+    if(!hash)
+        return NULL;
+
+    if(rhashtable_init(hash, family == AF_INET ?
+            &rt_prefix_hash_params4 : &rt_prefix_hash_params6)){
+        kfree(hash);
+        return NULL;
+    }
+    return hash;
 }
 
-void
-rt_free_rt_table(rt_table_t *rt_table){
+rt_entry_t *
+rt_prefix_hash_lookup(rt_prefix_hash_t *hash, uint8_t family, uint8_t *addr){
 
+    return rhashtable_lookup_fast(hash, addr, RT_PREFIX_HASH_PARAMS(family));
+}
 
+rt_bool_t
+rt_prefix_hash_insert(rt_prefix_hash_t *hash, rt_entry_t *rt_entry){
+
+    return rhashtable_lookup_insert_fast(hash, &rt_entry->rt_hash_node,
+                RT_PREFIX_HASH_PARAMS(rt_entry->family)) ? RT_FALSE : RT_TRUE;
 }
 
-void
-rt_dump_rt_table(rt_table_t *rt_table){
+/*Returns the number of entries left in hash*/
+uint32_t
+rt_prefix_hash_remove(rt_prefix_hash_t *hash, rt_entry_t *rt_entry){
+
+    rhashtable_remove_fast(hash, &rt_entry->rt_hash_node,
+        RT_PREFIX_HASH_PARAMS(rt_entry->family));
+    return atomic_read(&hash->nelems);
+}
 
-    glthread_t *curr;
-    rt_entry_t *rt_entry = NULL;
+/*rhashtables grow by themselves*/
+void
+rt_prefix_hash_reserve(rt_prefix_hash_t *hash, uint8_t family, uint32_t n){
 
-    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+}
 
-        rt_entry = rt_entry_glue_to_rt_entry(curr);
+void
+rt_prefix_hash_destroy(rt_prefix_hash_t *hash){
 
-        printk(KERN_INFO "%-20s %-4d %-20s %s\n",
-                rt_entry->dest_ip,
-                rt_entry->mask,
-                rt_entry->gw_ip,
-                rt_entry->oif);
-    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+    rhashtable_destroy(hash);
+    kfree(hash);
 }
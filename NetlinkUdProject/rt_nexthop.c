@@ -0,0 +1,528 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_nexthop.c
+ *
+ *    Description:  Implementation of shared next hops of the routes of a routing table
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 02:40:09 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_nexthop.h"
+
+#define RT_NEXTHOP_MIN_CAPACITY     64
+#define RT_NEXTHOP_GROUP_MIN_CAPACITY   16
+
+/*FNV-1a*/
+static inline uint32_t
+rt_nexthop_hash_bytes(uint32_t h, const void *data, uint32_t len){
+
+    const uint8_t *bytes = data;
+    uint32_t i;
+
+    for(i = 0; i < len; i++){
+        h ^= bytes[i];
+        h *= 16777619U;
+    }
+    return h;
+}
+
+static inline uint32_t
+rt_nexthop_hash(uint8_t family, const uint8_t *gw_addr, uint32_t if_id){
+
+    uint32_t h = 2166136261U ^ family;
+
+    h = rt_nexthop_hash_bytes(h, gw_addr, RT_IPV6_ADDR_LEN);
+    h ^= if_id * 0x9E3779B1U;
+    return h ^ (h >> 15);
+}
+
+static inline uint32_t
+rt_nexthop_group_hash(const rt_nexthop_path_t *paths, uint32_t n){
+
+    uint32_t h = rt_nexthop_hash_bytes(2166136261U, paths, n * sizeof(rt_nexthop_path_t));
+
+    return h ^ (h >> 15);
+}
+
+static void
+rt_nexthop_hash_add(rt_nexthop_table_t *nh_table, uint32_t nh_id){
+
+    rt_nexthop_t *nh = &nh_table->nexthops[nh_id];
+    uint32_t *bucket = &nh_table->buckets[
+            rt_nexthop_hash(nh->family, nh->gw_addr, nh->if_id) &
+                (nh_table->n_buckets - 1)];
+
+    nh->next_id = *bucket;
+    *bucket = nh_id;
+}
+
+static void
+rt_nexthop_hash_remove(rt_nexthop_table_t *nh_table, uint32_t nh_id){
+
+    rt_nexthop_t *nh = &nh_table->nexthops[nh_id];
+    uint32_t *id = &nh_table->buckets[
+            rt_nexthop_hash(nh->family, nh->gw_addr, nh->if_id) &
+                (nh_table->n_buckets - 1)];
+
+    for(; *id != RT_NEXTHOP_INVALID_ID; id = &nh_table->nexthops[*id].next_id){
+        if(*id == nh_id){
+            *id = nh->next_id;
+            return;
+        }
+    }
+}
+
+/*Doubles the next hop array and the hash buckets and rehashes*/
+static rt_bool_t
+rt_nexthop_table_grow(rt_nexthop_table_t *nh_table){
+
+    uint32_t new_capacity = nh_table->capacity ?
+                nh_table->capacity * 2 : RT_NEXTHOP_MIN_CAPACITY;
+    rt_nexthop_t *nexthops = RT_CALLOC(new_capacity * sizeof(rt_nexthop_t));
+    rt_nexthop_t *old = nh_table->nexthops;
+    uint32_t *buckets = RT_CALLOC(new_capacity * sizeof(uint32_t));
+    uint32_t id;
+
+    if(!nexthops || !buckets){
+        RT_FREE(nexthops);
+        RT_FREE(buckets);
+        return RT_FALSE;
+    }
+
+    if(nh_table->capacity)
+        memcpy(nexthops, old, nh_table->capacity * sizeof(rt_nexthop_t));
+    RT_FREE(nh_table->buckets);
+
+    /*Lookups which loaded the old array are done with it before it goes*/
+    RT_PUBLISH(nh_table->nexthops, nexthops);
+    RT_FREE_DEFERRED(old);
+    nh_table->buckets = buckets;
+    nh_table->n_buckets = new_capacity;
+    nh_table->capacity = new_capacity;
+
+    memset(buckets, 0xFF, new_capacity * sizeof(uint32_t));
+    for(id = 0; id < nh_table->next_id; id++){
+        if(nexthops[id].ref_count)
+            rt_nexthop_hash_add(nh_table, id);
+    }
+    return RT_TRUE;
+}
+
+static void
+rt_nexthop_group_hash_add(rt_nexthop_table_t *nh_table, uint32_t group_id){
+
+    rt_nexthop_group_t *group = nh_table->groups[group_id];
+    uint32_t *bucket = &nh_table->group_buckets[
+            rt_nexthop_group_hash(group->paths, group->n_paths) &
+                (nh_table->n_group_buckets - 1)];
+
+    group->next_id = *bucket;
+    *bucket = group_id;
+}
+
+static void
+rt_nexthop_group_hash_remove(rt_nexthop_table_t *nh_table, uint32_t group_id){
+
+    rt_nexthop_group_t *group = nh_table->groups[group_id];
+    uint32_t *id = &nh_table->group_buckets[
+            rt_nexthop_group_hash(group->paths, group->n_paths) &
+                (nh_table->n_group_buckets - 1)];
+
+    for(; *id != RT_NEXTHOP_INVALID_ID; id = &nh_table->groups[*id]->next_id){
+        if(*id == group_id){
+            *id = group->next_id;
+            return;
+        }
+    }
+}
+
+/*Doubles the group array and the hash buckets and rehashes*/
+static rt_bool_t
+rt_nexthop_group_table_grow(rt_nexthop_table_t *nh_table){
+
+    uint32_t new_capacity = nh_table->group_capacity ?
+                nh_table->group_capacity * 2 : RT_NEXTHOP_GROUP_MIN_CAPACITY;
+    rt_nexthop_group_t **groups = RT_CALLOC(new_capacity * sizeof(rt_nexthop_group_t *));
+    rt_nexthop_group_t **old = nh_table->groups;
+    uint32_t *buckets = RT_CALLOC(new_capacity * sizeof(uint32_t));
+    uint32_t id;
+
+    if(!groups || !buckets){
+        RT_FREE(groups);
+        RT_FREE(buckets);
+        return RT_FALSE;
+    }
+
+    if(nh_table->group_capacity)
+        memcpy(groups, old,
+            nh_table->group_capacity * sizeof(rt_nexthop_group_t *));
+    RT_FREE(nh_table->group_buckets);
+
+    /*Lookups which loaded the old array are done with it before it goes*/
+    RT_PUBLISH(nh_table->groups, groups);
+    RT_FREE_DEFERRED(old);
+    nh_table->group_buckets = buckets;
+    nh_table->n_group_buckets = new_capacity;
+    nh_table->group_capacity = new_capacity;
+
+    memset(buckets, 0xFF, new_capacity * sizeof(uint32_t));
+    for(id = 0; id < nh_table->group_next_id; id++){
+        if(groups[id]->ref_count)
+            rt_nexthop_group_hash_add(nh_table, id);
+    }
+    return RT_TRUE;
+}
+
+void
+rt_nexthop_table_init(rt_nexthop_table_t *nh_table){
+
+    memset(nh_table, 0, sizeof(rt_nexthop_table_t));
+    rt_iface_table_init(&nh_table->ifaces);
+    nh_table->free_id = RT_NEXTHOP_INVALID_ID;
+    nh_table->retired_id = RT_NEXTHOP_INVALID_ID;
+    nh_table->group_free_id = RT_NEXTHOP_INVALID_ID;
+    nh_table->group_retired_id = RT_NEXTHOP_INVALID_ID;
+}
+
+void
+rt_nexthop_table_destroy(rt_nexthop_table_t *nh_table){
+
+    uint32_t id;
+
+    for(id = 0; id < nh_table->group_next_id; id++)
+        RT_FREE(nh_table->groups[id]);
+
+    RT_FREE(nh_table->groups);
+    RT_FREE(nh_table->group_buckets);
+    RT_FREE(nh_table->nexthops);
+    RT_FREE(nh_table->buckets);
+    rt_iface_table_destroy(&nh_table->ifaces);
+    rt_nexthop_table_init(nh_table);
+}
+
+uint32_t
+rt_nexthop_get(rt_nexthop_table_t *nh_table, uint8_t family,
+               const uint8_t *gw_addr, const char *oif){
+
+    uint32_t nh_id, if_id = rt_iface_get(&nh_table->ifaces, oif);
+    rt_nexthop_t *nh;
+
+    if(if_id == RT_IFACE_INVALID_ID)
+        return RT_NEXTHOP_INVALID_ID;
+
+    if(nh_table->n_buckets){
+
+        nh_id = nh_table->buckets[rt_nexthop_hash(family, gw_addr, if_id) &
+                    (nh_table->n_buckets - 1)];
+
+        for(; nh_id != RT_NEXTHOP_INVALID_ID; nh_id = nh->next_id){
+
+            nh = &nh_table->nexthops[nh_id];
+
+            if(nh->if_id == if_id && nh->family == family &&
+                memcmp(nh->gw_addr, gw_addr, RT_IPV6_ADDR_LEN) == 0){
+                rt_iface_put(&nh_table->ifaces, if_id);
+                nh->ref_count++;
+                return nh_id;
+            }
+        }
+    }
+
+    /*Prefer a fresh id to waiting until the retired ones may be reused*/
+    if(nh_table->free_id == RT_NEXTHOP_INVALID_ID &&
+        nh_table->next_id == nh_table->capacity &&
+        nh_table->retired_id != RT_NEXTHOP_INVALID_ID){
+        RT_SYNCHRONIZE();
+        nh_table->free_id = nh_table->retired_id;
+        nh_table->retired_id = RT_NEXTHOP_INVALID_ID;
+    }
+
+    if(nh_table->free_id != RT_NEXTHOP_INVALID_ID){
+        nh_id = nh_table->free_id;
+        nh_table->free_id = nh_table->nexthops[nh_id].next_id;
+    }
+    else{
+        if(nh_table->next_id == nh_table->capacity &&
+            !rt_nexthop_table_grow(nh_table)){
+            rt_iface_put(&nh_table->ifaces, if_id);
+            return RT_NEXTHOP_INVALID_ID;
+        }
+        nh_id = nh_table->next_id++;
+    }
+
+    nh = &nh_table->nexthops[nh_id];
+    memcpy(nh->gw_addr, gw_addr, RT_IPV6_ADDR_LEN);
+    nh->family = family;
+    /*Keeps the reference taken above*/
+    nh->if_id = if_id;
+    nh->ifindex = rt_iface_lookup(&nh_table->ifaces, if_id)->ifindex;
+    nh->ref_count = 1;
+    rt_nexthop_hash_add(nh_table, nh_id);
+    nh_table->n_nexthops++;
+    return nh_id;
+}
+
+static int
+rt_nexthop_path_cmp(const void *a, const void *b){
+
+    const rt_nexthop_path_t *p1 = a, *p2 = b;
+
+    return p1->nh_id < p2->nh_id ? -1 : p1->nh_id > p2->nh_id;
+}
+
+/*Index in group of the path via nh_id, -1 if none*/
+static int
+rt_nexthop_group_find_path(const rt_nexthop_group_t *group, uint32_t nh_id){
+
+    int lo = 0, hi = (int)group->n_paths - 1, mid;
+
+    while(lo <= hi){
+        mid = (lo + hi) / 2;
+        if(group->paths[mid].nh_id == nh_id)
+            return mid;
+        if(group->paths[mid].nh_id < nh_id)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -1;
+}
+
+/* Shares out the buckets of group by weight. The buckets of prev, or
+ * all of them if prev_nh_id is a next hop, keep their next hop while
+ * its path is short of its share*/
+static void
+rt_nexthop_group_fill(rt_nexthop_table_t *nh_table, rt_nexthop_group_t *group,
+                      uint32_t prev_id){
+
+    uint32_t share[RT_NEXTHOP_MAX_PATHS], count[RT_NEXTHOP_MAX_PATHS];
+    uint64_t total = 0;
+    uint32_t assigned = 0, b, p, nh_id;
+    const uint32_t *prev_buckets = NULL;
+    int i;
+
+    for(p = 0; p < group->n_paths; p++)
+        total += group->paths[p].weight;
+
+    for(p = 0; p < group->n_paths; p++){
+        share[p] = (uint32_t)((RT_NEXTHOP_GROUP_BUCKETS *
+                        (uint64_t)group->paths[p].weight) / total);
+        count[p] = 0;
+        assigned += share[p];
+    }
+
+    /*What the rounding left goes round robin*/
+    for(p = 0; assigned < RT_NEXTHOP_GROUP_BUCKETS; p = (p + 1) % group->n_paths){
+        share[p]++;
+        assigned++;
+    }
+
+    if(prev_id != RT_NEXTHOP_INVALID_ID && (prev_id & RT_NEXTHOP_GROUP))
+        prev_buckets = rt_nexthop_group(nh_table, prev_id)->buckets;
+
+    for(b = 0; b < RT_NEXTHOP_GROUP_BUCKETS; b++){
+
+        nh_id = prev_buckets ? prev_buckets[b] : prev_id;
+        i = nh_id == RT_NEXTHOP_INVALID_ID ? -1 :
+                rt_nexthop_group_find_path(group, nh_id);
+
+        if(i >= 0 && count[i] < share[i]){
+            group->buckets[b] = nh_id;
+            count[i]++;
+        }
+        else{
+            group->buckets[b] = RT_NEXTHOP_INVALID_ID;
+        }
+    }
+
+    for(b = 0, p = 0; b < RT_NEXTHOP_GROUP_BUCKETS; b++){
+
+        if(group->buckets[b] != RT_NEXTHOP_INVALID_ID)
+            continue;
+
+        while(count[p] >= share[p])
+            p++;
+
+        group->buckets[b] = group->paths[p].nh_id;
+        count[p]++;
+    }
+}
+
+uint32_t
+rt_nexthop_group_get(rt_nexthop_table_t *nh_table,
+                     const rt_nexthop_path_t *paths, uint32_t n, uint32_t prev_id){
+
+    rt_nexthop_path_t sorted[RT_NEXTHOP_MAX_PATHS];
+    rt_nexthop_group_t *group;
+    uint32_t group_id, i, n_sorted = 0;
+
+    if(!n || n > RT_NEXTHOP_MAX_PATHS)
+        return RT_NEXTHOP_INVALID_ID;
+
+    /*The same paths in any order make the same group, a next hop listed
+     * twice gets the sum of its weights*/
+    memcpy(sorted, paths, n * sizeof(rt_nexthop_path_t));
+    RT_SORT(sorted, n, sizeof(rt_nexthop_path_t), rt_nexthop_path_cmp);
+
+    for(i = 0; i < n; i++){
+
+        if(!sorted[i].weight)
+            sorted[i].weight = 1;
+
+        if(n_sorted && sorted[n_sorted - 1].nh_id == sorted[i].nh_id)
+            sorted[n_sorted - 1].weight += sorted[i].weight;
+        else
+            sorted[n_sorted++] = sorted[i];
+    }
+
+    if(nh_table->n_group_buckets){
+
+        group_id = nh_table->group_buckets[rt_nexthop_group_hash(sorted, n_sorted) &
+                        (nh_table->n_group_buckets - 1)];
+
+        for(; group_id != RT_NEXTHOP_INVALID_ID; group_id = group->next_id){
+
+            group = nh_table->groups[group_id];
+
+            if(group->n_paths == n_sorted &&
+                memcmp(group->paths, sorted, n_sorted * sizeof(rt_nexthop_path_t)) == 0){
+                group->ref_count++;
+                return group_id | RT_NEXTHOP_GROUP;
+            }
+        }
+    }
+
+    /*Prefer a fresh id to waiting until the retired ones may be reused*/
+    if(nh_table->group_free_id == RT_NEXTHOP_INVALID_ID &&
+        nh_table->group_next_id == nh_table->group_capacity &&
+        nh_table->group_retired_id != RT_NEXTHOP_INVALID_ID){
+        RT_SYNCHRONIZE();
+        nh_table->group_free_id = nh_table->group_retired_id;
+        nh_table->group_retired_id = RT_NEXTHOP_INVALID_ID;
+    }
+
+    if(nh_table->group_free_id != RT_NEXTHOP_INVALID_ID){
+        /*No lookup may be reading the group anymore, reused as is*/
+        group_id = nh_table->group_free_id;
+        group = nh_table->groups[group_id];
+        nh_table->group_free_id = group->next_id;
+        memset(group, 0, sizeof(rt_nexthop_group_t));
+    }
+    else{
+        if(nh_table->group_next_id == nh_table->group_capacity &&
+            !rt_nexthop_group_table_grow(nh_table))
+            return RT_NEXTHOP_INVALID_ID;
+
+        group = RT_CALLOC(sizeof(rt_nexthop_group_t));
+
+        if(!group)
+            return RT_NEXTHOP_INVALID_ID;
+
+        group_id = nh_table->group_next_id++;
+    }
+
+    group->n_paths = n_sorted;
+    memcpy(group->paths, sorted, n_sorted * sizeof(rt_nexthop_path_t));
+    group->ref_count = 1;
+
+    for(i = 0; i < n_sorted; i++)
+        nh_table->nexthops[sorted[i].nh_id].ref_count++;
+
+    rt_nexthop_group_fill(nh_table, group, prev_id);
+
+    /*Complete before a route may refer to it*/
+    RT_PUBLISH(nh_table->groups[group_id], group);
+    rt_nexthop_group_hash_add(nh_table, group_id);
+    nh_table->n_groups++;
+    return group_id | RT_NEXTHOP_GROUP;
+}
+
+static void
+rt_nexthop_group_put(rt_nexthop_table_t *nh_table, uint32_t group_id){
+
+    rt_nexthop_group_t *group = nh_table->groups[group_id];
+    uint32_t i;
+
+    if(--group->ref_count)
+        return;
+
+    rt_nexthop_group_hash_remove(nh_table, group_id);
+
+    for(i = 0; i < group->n_paths; i++)
+        rt_nexthop_put(nh_table, group->paths[i].nh_id);
+
+    /*Routes being deleted may still be looked up with this id*/
+    group->next_id = nh_table->group_retired_id;
+    nh_table->group_retired_id = group_id;
+    nh_table->n_groups--;
+}
+
+void
+rt_nexthop_put(rt_nexthop_table_t *nh_table, uint32_t nh_id){
+
+    rt_nexthop_t *nh;
+
+    if(nh_id & RT_NEXTHOP_GROUP){
+        rt_nexthop_group_put(nh_table, nh_id & ~RT_NEXTHOP_GROUP);
+        return;
+    }
+
+    nh = &nh_table->nexthops[nh_id];
+
+    if(--nh->ref_count)
+        return;
+
+    rt_nexthop_hash_remove(nh_table, nh_id);
+    /*Lookups only read the ifindex, which the next hop keeps*/
+    rt_iface_put(&nh_table->ifaces, nh->if_id);
+    /*Routes being deleted may still be looked up with this id*/
+    nh->next_id = nh_table->retired_id;
+    nh_table->retired_id = nh_id;
+    nh_table->n_nexthops--;
+}
+
+void
+rt_nexthop_table_flush(rt_nexthop_table_t *nh_table){
+
+    uint32_t nh_id;
+
+    /*Which drops their references on the next hops*/
+    for(nh_id = 0; nh_id < nh_table->group_next_id; nh_id++){
+
+        if(!nh_table->groups[nh_id]->ref_count)
+            continue;
+
+        nh_table->groups[nh_id]->ref_count = 1;
+        rt_nexthop_group_put(nh_table, nh_id);
+    }
+
+    for(nh_id = 0; nh_id < nh_table->next_id; nh_id++){
+
+        if(!nh_table->nexthops[nh_id].ref_count)
+            continue;
+
+        nh_table->nexthops[nh_id].ref_count = 1;
+        rt_nexthop_put(nh_table, nh_id);
+    }
+}
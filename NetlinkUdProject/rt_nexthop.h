@@ -0,0 +1,175 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_nexthop.h
+ *
+ *    Description:  Shared next hops of the routes of a routing table
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 02:40:09 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_NEXTHOP__
+#define __RT_NEXTHOP__
+
+#include "rt_common.h"
+#include "rt_iface.h"
+
+/* Routes do not carry their gateway, they refer to an interned next hop
+ * by its 32 bit id. Thousands of routes via the same gateway and
+ * interface share one rt_nexthop_t which is reference counted and
+ * recycled when the last route referring to it goes away.
+ *
+ * A multipath route refers to a next hop group instead, interned the
+ * same way, whose id has RT_NEXTHOP_GROUP set. Flows are spread over
+ * the paths of a group by hashing them to RT_NEXTHOP_GROUP_BUCKETS
+ * buckets, each holding a next hop id, shared out in proportion to the
+ * weights of the paths. A group is never modified once in use, a route
+ * which changes paths moves to another group. When that group is
+ * created, it keeps the buckets of the previous one whose next hop
+ * remains, so only the flows of the buckets which had to move change
+ * next hop (resilient hashing)*/
+
+#define RT_NEXTHOP_INVALID_ID   0xFFFFFFFFU
+#define RT_NEXTHOP_GROUP        (1U << 31)
+#define RT_NEXTHOP_MAX_PATHS    64
+#define RT_NEXTHOP_GROUP_BUCKETS    256
+
+typedef struct rt_nexthop_{
+
+    uint8_t gw_addr[RT_IPV6_ADDR_LEN];  /*Network byte order, all zero if none*/
+    uint8_t family;
+    uint32_t ifindex;                   /*Of oif, 0 if it does not exist*/
+    uint32_t if_id;                     /*oif, in rt_nexthop_table_t.ifaces*/
+    uint32_t ref_count;
+    /*Next id in the same hash bucket, or next free id if unused*/
+    uint32_t next_id;
+} rt_nexthop_t;
+
+typedef struct rt_nexthop_path_{
+
+    uint32_t nh_id;
+    uint32_t weight;        /*Relative to the other paths, 0 counts as 1*/
+} rt_nexthop_path_t;
+
+typedef struct rt_nexthop_group_{
+
+    uint32_t ref_count;
+    /*Next id in the same hash bucket, or next free id if unused*/
+    uint32_t next_id;
+    uint32_t n_paths;
+    rt_nexthop_path_t paths[RT_NEXTHOP_MAX_PATHS];  /*Sorted by nh_id*/
+    uint32_t buckets[RT_NEXTHOP_GROUP_BUCKETS];     /*Next hop ids*/
+} rt_nexthop_group_t;
+
+typedef struct rt_nexthop_table_{
+
+    rt_nexthop_t *nexthops;     /*Indexed by next hop id*/
+    uint32_t capacity;
+    uint32_t next_id;           /*Ids below this have been handed out once*/
+    uint32_t free_id;           /*Head of the list of recycled ids*/
+    /*Ids released since the last RT_SYNCHRONIZE(), not reusable yet*/
+    uint32_t retired_id;
+    uint32_t n_nexthops;
+    uint32_t *buckets;
+    uint32_t n_buckets;         /*Power of 2*/
+    /*Groups by id without RT_NEXTHOP_GROUP, their ids are managed as
+     * above. The memory of a group is kept until its id is reused*/
+    rt_nexthop_group_t **groups;
+    uint32_t group_capacity;
+    uint32_t group_next_id;
+    uint32_t group_free_id;
+    uint32_t group_retired_id;
+    uint32_t n_groups;
+    uint32_t *group_buckets;
+    uint32_t n_group_buckets;   /*Power of 2*/
+    rt_iface_table_t ifaces;    /*Each next hop holds a reference on its oif*/
+} rt_nexthop_table_t;
+
+void
+rt_nexthop_table_init(rt_nexthop_table_t *nh_table);
+
+void
+rt_nexthop_table_destroy(rt_nexthop_table_t *nh_table);
+
+/* Returns the id of the next hop for gw_addr via oif, creating it if
+ * needed, and takes a reference on it. RT_NEXTHOP_INVALID_ID on alloc
+ * failure*/
+uint32_t
+rt_nexthop_get(rt_nexthop_table_t *nh_table, uint8_t family,
+               const uint8_t *gw_addr, const char *oif);
+
+/* Returns the id of the group of the n paths, creating it if needed,
+ * and takes a reference on it. The group holds its own references on
+ * the next hops of the paths. prev_id is the group or next hop the
+ * route used so far, or RT_NEXTHOP_INVALID_ID, for a new group to keep
+ * its buckets. RT_NEXTHOP_INVALID_ID if n is 0 or more than
+ * RT_NEXTHOP_MAX_PATHS, or on alloc failure*/
+uint32_t
+rt_nexthop_group_get(rt_nexthop_table_t *nh_table,
+                     const rt_nexthop_path_t *paths, uint32_t n, uint32_t prev_id);
+
+/*Drops a reference taken by rt_nexthop_get() or rt_nexthop_group_get()*/
+void
+rt_nexthop_put(rt_nexthop_table_t *nh_table, uint32_t nh_id);
+
+/* Drops all the references at once, as when every route goes away. The
+ * ids retire as with rt_nexthop_put(), so lookups in flight may still
+ * use them. Costs the number of next hops, not of routes*/
+void
+rt_nexthop_table_flush(rt_nexthop_table_t *nh_table);
+
+static inline rt_nexthop_t *
+rt_nexthop_lookup(rt_nexthop_table_t *nh_table, uint32_t nh_id){
+
+    return &RT_DEREF(nh_table->nexthops)[nh_id];
+}
+
+/*Writer side, the name of the outgoing interface of nh*/
+static inline const char *
+rt_nexthop_oif(rt_nexthop_table_t *nh_table, rt_nexthop_t *nh){
+
+    return rt_iface_lookup(&nh_table->ifaces, nh->if_id)->name;
+}
+
+/*Writer side, the group of a group id*/
+static inline rt_nexthop_group_t *
+rt_nexthop_group(rt_nexthop_table_t *nh_table, uint32_t group_id){
+
+    return nh_table->groups[group_id & ~RT_NEXTHOP_GROUP];
+}
+
+/* The next hop a flow takes, nh_id being a next hop or a group id and
+ * flow_hash any hash of the flow, say of its addresses and ports*/
+static inline rt_nexthop_t *
+rt_nexthop_select(rt_nexthop_table_t *nh_table, uint32_t nh_id, uint32_t flow_hash){
+
+    rt_nexthop_group_t *group;
+
+    if(nh_id & RT_NEXTHOP_GROUP){
+        group = RT_DEREF(RT_DEREF(nh_table->groups)[nh_id & ~RT_NEXTHOP_GROUP]);
+        nh_id = group->buckets[flow_hash % RT_NEXTHOP_GROUP_BUCKETS];
+    }
+    return rt_nexthop_lookup(nh_table, nh_id);
+}
+
+#endif /* __RT_NEXTHOP__ */
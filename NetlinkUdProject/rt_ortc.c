@@ -0,0 +1,376 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_ortc.c
+ *
+ *    Description:  Implementation of the forwarding equivalent compression of a set of routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 08:21:54 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifdef __KERNEL__
+#include <linux/socket.h>   /*AF_INET/AF_INET6*/
+#else
+#include <sys/socket.h>
+#endif
+#include "rt_ortc.h"
+
+#define RT_ORTC_MIN_NODES   1024
+
+/* A set holds refs to routes, route index + 1, standing for their
+ * label. Ref 0 is no route, a set holding it holds nothing else*/
+typedef struct rt_ortc_node_{
+
+    uint32_t child[2];      /*0 if none, the root is never a child*/
+    uint32_t route;         /*Ref of the route of this prefix, 0 if none*/
+    uint32_t n_set;
+    uint32_t set[RT_ORTC_MAX_SET];  /*Sorted by label*/
+} rt_ortc_node_t;
+
+typedef struct rt_ortc_{
+
+    const rt_fib_result_t *routes;
+    const uint32_t *labels;
+    rt_ortc_node_t *nodes;
+    uint32_t n_nodes;
+    uint32_t capacity;
+    rt_fib_result_t *out;
+    uint32_t n_out;
+    uint32_t max_out;
+} rt_ortc_t;
+
+/*Of the walks down the trie, explicit as the kernel stack is small*/
+typedef struct rt_ortc_frame_{
+
+    uint32_t node;
+    uint32_t inherited;     /*Ref of the route covering the node*/
+    uint32_t chosen;        /*Ref the parent forwards to, or its own*/
+    uint8_t depth;
+    uint8_t next_child;
+    uint8_t key[RT_IPV6_ADDR_LEN];
+} rt_ortc_frame_t;
+
+/*Label of a ref, 0 for no route*/
+static inline uint64_t
+rt_ortc_label(const rt_ortc_t *ortc, uint32_t ref){
+
+    return ref ? (uint64_t)ortc->labels[ref - 1] + 1 : 0;
+}
+
+static inline uint8_t
+rt_ortc_bit(const uint8_t *key, uint32_t depth){
+
+    return (key[depth / 8] >> (7 - (depth % 8))) & 1;
+}
+
+static uint32_t
+rt_ortc_node_new(rt_ortc_t *ortc){
+
+    uint32_t capacity;
+    rt_ortc_node_t *nodes;
+
+    if(ortc->n_nodes == ortc->capacity){
+
+        capacity = ortc->capacity ? ortc->capacity * 2 : RT_ORTC_MIN_NODES;
+        nodes = RT_CALLOC_LARGE((uint64_t)capacity * sizeof(rt_ortc_node_t));
+
+        if(!nodes)
+            return 0;
+
+        if(ortc->n_nodes)
+            memcpy(nodes, ortc->nodes, (uint64_t)ortc->n_nodes * sizeof(rt_ortc_node_t));
+        RT_FREE_LARGE(ortc->nodes);
+        ortc->nodes = nodes;
+        ortc->capacity = capacity;
+    }
+
+    memset(&ortc->nodes[ortc->n_nodes], 0, sizeof(rt_ortc_node_t));
+    return ortc->n_nodes++;
+}
+
+/*Trie of the routes of family, node 0 being the root*/
+static rt_bool_t
+rt_ortc_build(rt_ortc_t *ortc, uint32_t n, uint8_t family){
+
+    const rt_fib_result_t *route;
+    uint32_t i, depth, node, child;
+    uint8_t b;
+
+    /*The root, 0 is also what rt_ortc_node_new() returns on failure*/
+    ortc->n_nodes = 0;
+    rt_ortc_node_new(ortc);
+    if(!ortc->n_nodes)
+        return RT_FALSE;
+
+    for(i = 0; i < n; i++){
+
+        route = &ortc->routes[i];
+
+        if(route->family != family)
+            continue;
+
+        for(node = 0, depth = 0; depth < route->mask; depth++){
+
+            b = rt_ortc_bit(route->dest_addr, depth);
+            child = ortc->nodes[node].child[b];
+
+            if(!child){
+                child = rt_ortc_node_new(ortc);
+                if(!child)
+                    return RT_FALSE;
+                ortc->nodes[node].child[b] = child;
+            }
+            node = child;
+        }
+        ortc->nodes[node].route = i + 1;
+    }
+    return RT_TRUE;
+}
+
+/* a # b into set : the intersection of a and b if not empty, their
+ * union otherwise, within RT_ORTC_MAX_SET*/
+static uint32_t
+rt_ortc_merge(const rt_ortc_t *ortc, const uint32_t *a, uint32_t n_a,
+              const uint32_t *b, uint32_t n_b, uint32_t *set){
+
+    uint32_t i = 0, j = 0, n = 0;
+    uint64_t la, lb;
+
+    /*A subtree with an address without route is left to itself*/
+    if(!a[0] || !b[0]){
+        set[0] = 0;
+        return 1;
+    }
+
+    while(i < n_a && j < n_b){
+        la = rt_ortc_label(ortc, a[i]);
+        lb = rt_ortc_label(ortc, b[j]);
+        if(la == lb){
+            if(n < RT_ORTC_MAX_SET)
+                set[n++] = a[i];
+            i++;
+            j++;
+        }
+        else if(la < lb)
+            i++;
+        else
+            j++;
+    }
+
+    if(n)
+        return n;
+
+    for(i = 0, j = 0; (i < n_a || j < n_b) && n < RT_ORTC_MAX_SET;){
+        la = i < n_a ? rt_ortc_label(ortc, a[i]) : ~0ULL;
+        lb = j < n_b ? rt_ortc_label(ortc, b[j]) : ~0ULL;
+        if(la <= lb){
+            set[n++] = a[i++];
+            if(la == lb)
+                j++;
+        }
+        else
+            set[n++] = b[j++];
+    }
+    return n;
+}
+
+/*Bottom up, the set of every node*/
+static void
+rt_ortc_sets(rt_ortc_t *ortc, rt_ortc_frame_t *stack){
+
+    rt_ortc_frame_t *top;
+    rt_ortc_node_t *node, *c0, *c1;
+    uint32_t sp = 0, child, inherited;
+
+    stack[0].node = 0;
+    stack[0].inherited = ortc->nodes[0].route;
+    stack[0].next_child = 0;
+
+    while(1){
+
+        top = &stack[sp];
+        node = &ortc->nodes[top->node];
+
+        if(top->next_child < 2){
+            child = node->child[top->next_child++];
+            if(child){
+                stack[++sp].node = child;
+                stack[sp].inherited = ortc->nodes[child].route ?
+                                        ortc->nodes[child].route : top->inherited;
+                stack[sp].next_child = 0;
+            }
+            continue;
+        }
+
+        /*A missing child is a leaf with the route of the node*/
+        inherited = top->inherited;
+        c0 = node->child[0] ? &ortc->nodes[node->child[0]] : NULL;
+        c1 = node->child[1] ? &ortc->nodes[node->child[1]] : NULL;
+
+        if(!c0 && !c1){
+            node->set[0] = inherited;
+            node->n_set = 1;
+        }
+        else{
+            node->n_set = rt_ortc_merge(ortc,
+                            c0 ? c0->set : &inherited, c0 ? c0->n_set : 1,
+                            c1 ? c1->set : &inherited, c1 ? c1->n_set : 1,
+                            node->set);
+        }
+
+        if(!sp)
+            return;
+        sp--;
+    }
+}
+
+static rt_bool_t
+rt_ortc_emit(rt_ortc_t *ortc, const uint8_t *key, uint8_t depth, uint32_t ref){
+
+    rt_fib_result_t *route;
+    uint32_t i;
+
+    if(ortc->n_out == ortc->max_out)
+        return RT_FALSE;
+
+    route = &ortc->out[ortc->n_out++];
+    *route = ortc->routes[ref - 1];
+    memset(route->dest_addr, 0, sizeof(route->dest_addr));
+
+    for(i = 0; i < depth; i++){
+        if(rt_ortc_bit(key, i))
+            route->dest_addr[i / 8] |= 0x80 >> (i % 8);
+    }
+    route->mask = depth;
+    return RT_TRUE;
+}
+
+/*Top down, the prefixes to emit. RT_FALSE if more than max_out*/
+static rt_bool_t
+rt_ortc_select(rt_ortc_t *ortc, rt_ortc_frame_t *stack){
+
+    rt_ortc_frame_t frame, *child_frame;
+    rt_ortc_node_t *node;
+    uint32_t sp = 1, i, chosen, inherited, child;
+    uint64_t label;
+    uint8_t b;
+
+    memset(&stack[0], 0, sizeof(rt_ortc_frame_t));
+    stack[0].inherited = ortc->nodes[0].route;
+
+    while(sp){
+
+        frame = stack[--sp];
+        node = &ortc->nodes[frame.node];
+        label = rt_ortc_label(ortc, frame.chosen);
+        chosen = node->set[0];
+
+        for(i = 0; i < node->n_set; i++){
+            if(rt_ortc_label(ortc, node->set[i]) == label){
+                chosen = frame.chosen;
+                break;
+            }
+        }
+
+        if(rt_ortc_label(ortc, chosen) != label &&
+            !rt_ortc_emit(ortc, frame.key, frame.depth, chosen))
+            return RT_FALSE;
+
+        /*Leaves have no children, their set being what they inherit*/
+        if(!node->child[0] && !node->child[1])
+            continue;
+
+        for(b = 0; b < 2; b++){
+
+            child = node->child[b];
+            inherited = frame.inherited;
+
+            if(!child){
+                /*The missing child forwards to inherited*/
+                if(rt_ortc_label(ortc, inherited) == rt_ortc_label(ortc, chosen))
+                    continue;
+                frame.key[frame.depth / 8] &= ~(0x80 >> (frame.depth % 8));
+                frame.key[frame.depth / 8] |= b << (7 - (frame.depth % 8));
+                if(!rt_ortc_emit(ortc, frame.key, frame.depth + 1, inherited))
+                    return RT_FALSE;
+                continue;
+            }
+
+            child_frame = &stack[sp++];
+            *child_frame = frame;
+            child_frame->node = child;
+            child_frame->chosen = chosen;
+            child_frame->depth = frame.depth + 1;
+            if(ortc->nodes[child].route)
+                child_frame->inherited = ortc->nodes[child].route;
+            child_frame->key[frame.depth / 8] &= ~(0x80 >> (frame.depth % 8));
+            child_frame->key[frame.depth / 8] |= b << (7 - (frame.depth % 8));
+        }
+    }
+    return RT_TRUE;
+}
+
+uint32_t
+rt_ortc_compress(const rt_fib_result_t *routes, const uint32_t *labels,
+                 uint32_t n, rt_fib_result_t *out){
+
+    static const uint8_t families[] = {AF_INET, AF_INET6};
+    rt_ortc_t ortc;
+    rt_ortc_frame_t *stack;
+    uint32_t f, n_out = 0;
+
+    if(!n)
+        return 0;
+
+    /*A walk holds at most two nodes per level*/
+    stack = RT_CALLOC(2 * (RT_IPV6_MAX_MASK + 2) * sizeof(rt_ortc_frame_t));
+    if(!stack)
+        return 0;
+
+    memset(&ortc, 0, sizeof(ortc));
+    ortc.routes = routes;
+    ortc.labels = labels;
+    ortc.out = out;
+    ortc.max_out = n - 1;
+
+    for(f = 0; f < sizeof(families); f++){
+
+        if(!rt_ortc_build(&ortc, n, families[f]))
+            goto done;
+
+        /*Only the root, no route of this family*/
+        if(ortc.n_nodes == 1 && !ortc.nodes[0].route)
+            continue;
+
+        rt_ortc_sets(&ortc, stack);
+
+        if(!rt_ortc_select(&ortc, stack))
+            goto done;
+    }
+    n_out = ortc.n_out;
+
+done:
+    RT_FREE_LARGE(ortc.nodes);
+    RT_FREE(stack);
+    return n_out;
+}
@@ -0,0 +1,63 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_ortc.h
+ *
+ *    Description:  Forwarding equivalent compression of a set of routes (ORTC)
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 08:21:54 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_ORTC__
+#define __RT_ORTC__
+
+#include "rt_common.h"
+#include "rt_fib.h"
+
+/* Optimal Routing Table Constructor (Draves et al.). The routes are put
+ * in a binary trie where every node gets the set of next hops which,
+ * if the node forwarded to them, let its subtree be expressed with the
+ * fewest prefixes : for a leaf the next hop it inherits, for the others
+ * the intersection of the sets of the two children if not empty, their
+ * union otherwise. Walking down, a node emits a prefix only when the
+ * next hop inherited from above is not in its set. The result forwards
+ * every address as the routes do, with typically a third to a half
+ * fewer prefixes when more specifics go the way of their covering
+ * route.
+ *
+ * A node is never covered by a prefix over an address without a route,
+ * as that takes a prefix with no next hop, which a FIB cannot hold. The
+ * sets are bounded, which may cost a few prefixes over the optimum*/
+
+#define RT_ORTC_MAX_SET     4
+
+/* Writes to out, room for n routes, a minimal set of routes forwarding
+ * as the n routes do. labels[i] tells where routes[i] goes, routes
+ * going the same way having the same label. An emitted route is a copy
+ * of one of them but for its prefix. Returns the number of routes
+ * written, 0 on alloc failure or if they would not be fewer than n*/
+uint32_t
+rt_ortc_compress(const rt_fib_result_t *routes, const uint32_t *labels,
+                 uint32_t n, rt_fib_result_t *out);
+
+#endif /* __RT_ORTC__ */
@@ -0,0 +1,81 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_platform.h
+ *
+ *    Description:  This file declares what rt_table.c expects from rt_kern.c in the LKM
+ *                  and from rt_user.c in user space
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:05:12 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_PLATFORM__
+#define __RT_PLATFORM__
+
+#include "rt.h"
+
+/*printk(KERN_INFO ...) in the kernel, printf() in user space*/
+void
+rt_log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/*Writers of a table are serialized, lookups take no lock*/
+void
+rt_table_lock(rt_table_t *rt_table);
+
+void
+rt_table_unlock(rt_table_t *rt_table);
+
+/*Exact match hash of the prefixes of one length, see rt_prefix_index_t*/
+rt_prefix_hash_t *
+rt_prefix_hash_create(uint8_t family);
+
+rt_entry_t *
+rt_prefix_hash_lookup(rt_prefix_hash_t *hash, uint8_t family, uint8_t *addr);
+
+/*RT_FALSE if an entry of the same prefix is present*/
+rt_bool_t
+rt_prefix_hash_insert(rt_prefix_hash_t *hash, rt_entry_t *rt_entry);
+
+/*Returns the number of entries left in hash*/
+uint32_t
+rt_prefix_hash_remove(rt_prefix_hash_t *hash, rt_entry_t *rt_entry);
+
+/*Room for n more entries at once, a hint only*/
+void
+rt_prefix_hash_reserve(rt_prefix_hash_t *hash, uint8_t family, uint32_t n);
+
+void
+rt_prefix_hash_destroy(rt_prefix_hash_t *hash);
+
+/*Text to address, the IPV4 one in host byte order*/
+rt_bool_t
+rt_ipv4_pton(char *ip, uint32_t *addr);
+
+rt_bool_t
+rt_ipv6_pton(char *ip, uint8_t *addr);
+
+/*Text form of the gateway of nh, "" if none*/
+void
+rt_gw_ntop(rt_nexthop_t *nh, char *buf, uint32_t buf_len);
+
+#endif /* __RT_PLATFORM__ */
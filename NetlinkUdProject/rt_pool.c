@@ -0,0 +1,322 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_pool.c
+ *
+ *    Description:  Fixed size object pool used to allocate routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 11:40:27 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_pool.h"
+
+#ifdef __KERNEL__
+
+#include <linux/mutex.h>
+
+/* Slab caches of the module, slab names must be unique. Made by the
+ * first pool of their name, destroyed with the last one*/
+#define RT_POOL_MAX_CACHES  8
+
+typedef struct rt_pool_cache_{
+
+    const char *name;
+    uint32_t obj_size;
+    uint32_t n_pools;
+    struct kmem_cache *cache;
+} rt_pool_cache_t;
+
+static rt_pool_cache_t rt_pool_caches[RT_POOL_MAX_CACHES];
+static DEFINE_MUTEX(rt_pool_caches_lock);
+
+static rt_pool_cache_t *
+rt_pool_cache_get(const char *name, uint32_t obj_size){
+
+    rt_pool_cache_t *shared, *free_slot = NULL;
+    uint32_t i;
+
+    mutex_lock(&rt_pool_caches_lock);
+
+    for(i = 0; i < RT_POOL_MAX_CACHES; i++){
+
+        shared = &rt_pool_caches[i];
+
+        if(!shared->n_pools){
+            if(!free_slot)
+                free_slot = shared;
+            continue;
+        }
+
+        if(strcmp(shared->name, name) == 0 && shared->obj_size == obj_size){
+            shared->n_pools++;
+            mutex_unlock(&rt_pool_caches_lock);
+            return shared;
+        }
+    }
+
+    shared = free_slot;
+    if(shared){
+        shared->cache = kmem_cache_create(name, obj_size, RT_POOL_ALIGN,
+                            SLAB_HWCACHE_ALIGN, NULL);
+        if(shared->cache){
+            shared->name = name;
+            shared->obj_size = obj_size;
+            shared->n_pools = 1;
+        }
+        else
+            shared = NULL;
+    }
+
+    mutex_unlock(&rt_pool_caches_lock);
+    return shared;
+}
+
+static void
+rt_pool_cache_put(rt_pool_cache_t *shared){
+
+    struct kmem_cache *cache = NULL;
+
+    mutex_lock(&rt_pool_caches_lock);
+    if(--shared->n_pools == 0){
+        cache = shared->cache;
+        shared->cache = NULL;
+    }
+    mutex_unlock(&rt_pool_caches_lock);
+
+    if(!cache)
+        return;
+
+    /*Objects freed by rt_pool_free_rcu() may not be back in the cache yet*/
+    rcu_barrier();
+    kmem_cache_destroy(cache);
+}
+
+void
+rt_pool_init(rt_pool_t *pool, const char *name, uint32_t obj_size){
+
+    memset(pool, 0, sizeof(rt_pool_t));
+    pool->obj_size = obj_size;
+    pool->shared = rt_pool_cache_get(name, obj_size);
+    if(pool->shared)
+        pool->cache = pool->shared->cache;
+}
+
+void
+rt_pool_destroy(rt_pool_t *pool){
+
+    if(pool->shared)
+        rt_pool_cache_put(pool->shared);
+    else
+        /*The callbacks of rt_pool_free_rcu() are code of the module*/
+        rcu_barrier();
+    pool->shared = NULL;
+    pool->cache = NULL;
+    pool->n_objs = 0;
+    pool->mem_bytes = 0;
+}
+
+void *
+rt_pool_alloc(rt_pool_t *pool){
+
+    void *obj = pool->cache ? kmem_cache_zalloc(pool->cache, GFP_KERNEL) :
+                    kzalloc(pool->obj_size, GFP_KERNEL);
+
+    if(!obj)
+        return NULL;
+
+    pool->n_objs++;
+    /*Slab pages are shared by the objects, account the objects*/
+    pool->mem_bytes += pool->obj_size;
+    return obj;
+}
+
+rt_bool_t
+rt_pool_alloc_bulk(rt_pool_t *pool, uint32_t n, void **objs){
+
+    uint32_t i;
+
+    if(pool->cache){
+        if(kmem_cache_alloc_bulk(pool->cache, GFP_KERNEL | __GFP_ZERO, n, objs) != n)
+            return RT_FALSE;
+    }
+    else{
+        for(i = 0; i < n; i++){
+            objs[i] = kzalloc(pool->obj_size, GFP_KERNEL);
+            if(!objs[i]){
+                while(i--)
+                    kfree(objs[i]);
+                return RT_FALSE;
+            }
+        }
+    }
+
+    pool->n_objs += n;
+    pool->mem_bytes += (uint64_t)n * pool->obj_size;
+    return RT_TRUE;
+}
+
+void
+rt_pool_free(rt_pool_t *pool, void *obj){
+
+    if(pool->cache)
+        kmem_cache_free(pool->cache, obj);
+    else
+        kfree(obj);
+
+    pool->n_objs--;
+    pool->mem_bytes -= pool->obj_size;
+}
+
+#else
+
+void
+rt_pool_init(rt_pool_t *pool, const char *name, uint32_t obj_size){
+
+    (void)name;
+    memset(pool, 0, sizeof(rt_pool_t));
+    /*Room for the free list link, and keep the objects aligned*/
+    if(obj_size < sizeof(void *))
+        obj_size = sizeof(void *);
+    pool->obj_size = (obj_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+}
+
+void
+rt_pool_destroy(rt_pool_t *pool){
+
+    uint32_t i;
+    uint32_t obj_size = pool->obj_size;
+
+    for(i = 0; i < pool->n_chunks; i++)
+        free(pool->chunks[i]);
+
+    free(pool->chunks);
+    memset(pool, 0, sizeof(rt_pool_t));
+    pool->obj_size = obj_size;
+}
+
+static rt_bool_t
+rt_pool_add_chunk(rt_pool_t *pool, uint32_t chunk_objs){
+
+    void **chunks;
+    void *chunk;
+    uint32_t capacity;
+    size_t chunk_size = (size_t)pool->obj_size * chunk_objs;
+
+    if(pool->n_chunks == pool->chunks_capacity){
+
+        capacity = pool->chunks_capacity ? pool->chunks_capacity * 2 : 16;
+        chunks = realloc(pool->chunks, capacity * sizeof(void *));
+
+        if(!chunks)
+            return RT_FALSE;
+
+        pool->chunks = chunks;
+        pool->chunks_capacity = capacity;
+    }
+
+    /*chunk_size is a multiple of RT_POOL_ALIGN as aligned_alloc wants*/
+    chunk_size = (chunk_size + RT_POOL_ALIGN - 1) & ~((size_t)RT_POOL_ALIGN - 1);
+    chunk = aligned_alloc(RT_POOL_ALIGN, chunk_size);
+
+    if(!chunk)
+        return RT_FALSE;
+
+    pool->chunks[pool->n_chunks++] = chunk;
+    pool->chunk_objs = chunk_objs;
+    pool->chunk_used = 0;
+    pool->mem_bytes += chunk_size;
+    return RT_TRUE;
+}
+
+void *
+rt_pool_alloc(rt_pool_t *pool){
+
+    void *obj;
+
+    if(pool->free_list){
+        obj = pool->free_list;
+        pool->free_list = *(void **)obj;
+    }
+    else{
+        if((!pool->n_chunks || pool->chunk_used == pool->chunk_objs) &&
+            !rt_pool_add_chunk(pool, RT_POOL_CHUNK_OBJS))
+            return NULL;
+
+        obj = (char *)pool->chunks[pool->n_chunks - 1] +
+                (size_t)pool->chunk_used++ * pool->obj_size;
+    }
+
+    memset(obj, 0, pool->obj_size);
+    pool->n_objs++;
+    return obj;
+}
+
+rt_bool_t
+rt_pool_alloc_bulk(rt_pool_t *pool, uint32_t n, void **objs){
+
+    uint32_t i;
+    char *obj;
+
+    if(n < RT_POOL_CHUNK_OBJS){
+        for(i = 0; i < n; i++){
+            objs[i] = rt_pool_alloc(pool);
+            if(!objs[i]){
+                while(i--)
+                    rt_pool_free(pool, objs[i]);
+                return RT_FALSE;
+            }
+        }
+        return RT_TRUE;
+    }
+
+    /*The rest of the last chunk goes to the free list, not to waste*/
+    while(pool->n_chunks && pool->chunk_used < pool->chunk_objs){
+        obj = (char *)pool->chunks[pool->n_chunks - 1] +
+                (size_t)pool->chunk_used++ * pool->obj_size;
+        *(void **)obj = pool->free_list;
+        pool->free_list = obj;
+    }
+
+    if(!rt_pool_add_chunk(pool, n))
+        return RT_FALSE;
+
+    obj = pool->chunks[pool->n_chunks - 1];
+    memset(obj, 0, (size_t)n * pool->obj_size);
+
+    for(i = 0; i < n; i++)
+        objs[i] = obj + (size_t)i * pool->obj_size;
+
+    pool->chunk_used = n;
+    pool->n_objs += n;
+    return RT_TRUE;
+}
+
+void
+rt_pool_free(rt_pool_t *pool, void *obj){
+
+    *(void **)obj = pool->free_list;
+    pool->free_list = obj;
+    pool->n_objs--;
+}
+
+#endif
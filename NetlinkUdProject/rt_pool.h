@@ -0,0 +1,111 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_pool.h
+ *
+ *    Description:  Fixed size object pool used to allocate routes
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 11:40:27 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_POOL__
+#define __RT_POOL__
+
+#include "rt_common.h"
+
+/* Every rt_table_t allocates its routes from a pool of its own. In the
+ * kernel the pools of a name share one slab cache of the module, each
+ * pool counting its own objects, in user space a pool is an arena of
+ * large chunks carved into objects with recycled objects kept on a free
+ * list, so loading a full table costs a few hundred allocations instead
+ * of one per route. Either way the pool accounts for the memory of the
+ * table*/
+
+#define RT_POOL_CHUNK_OBJS      4096
+#define RT_POOL_ALIGN           64
+
+typedef struct rt_pool_{
+
+    uint32_t obj_size;
+    uint32_t n_objs;        /*Objects handed out*/
+    uint64_t mem_bytes;     /*Memory held by the pool*/
+#ifdef __KERNEL__
+    /*NULL if the cache could not be created, then kzalloc is used*/
+    struct kmem_cache *cache;
+    struct rt_pool_cache_ *shared;  /*Holder of the cache, see rt_pool.c*/
+#else
+    void **chunks;
+    uint32_t n_chunks;
+    uint32_t chunks_capacity;
+    uint32_t chunk_objs;    /*Objects the last chunk holds*/
+    uint32_t chunk_used;    /*Objects carved out of the last chunk*/
+    void *free_list;        /*Linked through the first word of the objects*/
+#endif
+} rt_pool_t;
+
+/* name must outlive the pool, pass a string literal. In the kernel the
+ * pools with the same name and obj_size share a cache*/
+void
+rt_pool_init(rt_pool_t *pool, const char *name, uint32_t obj_size);
+
+/*All objects must have been freed to the pool already*/
+void
+rt_pool_destroy(rt_pool_t *pool);
+
+/*Returns zeroed memory, NULL on alloc failure*/
+void *
+rt_pool_alloc(rt_pool_t *pool);
+
+/* Fills objs with n zeroed objects, all of them or none. The kernel
+ * takes them from the slab in one go, user space carves a large
+ * request out of a single chunk*/
+rt_bool_t
+rt_pool_alloc_bulk(rt_pool_t *pool, uint32_t n, void **objs);
+
+void
+rt_pool_free(rt_pool_t *pool, void *obj);
+
+#ifdef __KERNEL__
+/* Defines fn, the RCU callback freeing an object of type whose struct
+ * rcu_head member is rcu, for rt_pool_free_rcu(). kfree() takes the
+ * objects of any slab cache*/
+#define RT_POOL_DEFINE_RCU_FREE(fn, type, rcu)                  \
+    static void                                                 \
+    fn(struct rcu_head *head){                                  \
+                                                                \
+        kfree(container_of(head, type, rcu));                   \
+    }
+
+/* Frees obj once the RCU readers which may still see it are done, fn
+ * being defined by RT_POOL_DEFINE_RCU_FREE(). Through call_rcu() rather
+ * than kfree_rcu(), whose batches rcu_barrier() does not wait for, so
+ * that rt_pool_destroy() does not destroy a cache still holding obj*/
+#define rt_pool_free_rcu(pool, obj, rcu, fn)        \
+    do{                                             \
+        (pool)->n_objs--;                           \
+        (pool)->mem_bytes -= (pool)->obj_size;      \
+        call_rcu(&(obj)->rcu, fn);                  \
+    }while(0)
+#endif
+
+#endif /* __RT_POOL__ */
@@ -0,0 +1,128 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_sink.c
+ *
+ *    Description:  Implementation of the buffered sink the routing tables are dumped into
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:02:31 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifdef __KERNEL__
+#include <linux/kernel.h>   /*vsnprintf*/
+#else
+#include <stdio.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#include "rt_sink.h"
+
+void
+rt_sink_init(rt_sink_t *sink, char *buf, uint32_t size,
+             rt_sink_write_fn write_fn, void *arg){
+
+    sink->buf = buf;
+    sink->size = size;
+    sink->len = 0;
+    sink->failed = size < RT_SINK_MAX_PIECE ? RT_TRUE : RT_FALSE;
+    sink->write_fn = write_fn;
+    sink->arg = arg;
+}
+
+rt_bool_t
+rt_sink_flush(rt_sink_t *sink){
+
+    if(sink->len && !sink->failed && !sink->write_fn(sink->arg, sink->buf, sink->len))
+        sink->failed = RT_TRUE;
+
+    sink->len = 0;
+    return !sink->failed;
+}
+
+void
+rt_sink_put(rt_sink_t *sink, const void *data, uint32_t len){
+
+    const char *bytes = data;
+    uint32_t n;
+
+    while(len && !sink->failed){
+
+        if(sink->len == sink->size)
+            rt_sink_flush(sink);
+
+        n = sink->size - sink->len;
+        if(n > len)
+            n = len;
+
+        memcpy(sink->buf + sink->len, bytes, n);
+        sink->len += n;
+        bytes += n;
+        len -= n;
+    }
+}
+
+void
+rt_sink_printf(rt_sink_t *sink, const char *fmt, ...){
+
+    va_list args;
+    int n;
+
+    if(sink->size - sink->len < RT_SINK_MAX_PIECE)
+        rt_sink_flush(sink);
+
+    if(sink->failed)
+        return;
+
+    /*Formatted in place, longer pieces are cut*/
+    va_start(args, fmt);
+    n = vsnprintf(sink->buf + sink->len, RT_SINK_MAX_PIECE, fmt, args);
+    va_end(args);
+
+    if(n > 0)
+        sink->len += n < RT_SINK_MAX_PIECE ? n : RT_SINK_MAX_PIECE - 1;
+}
+
+#ifndef __KERNEL__
+rt_bool_t
+rt_sink_write_fd(void *arg, const void *data, uint32_t len){
+
+    int fd = *(int *)arg;
+    const char *bytes = data;
+    ssize_t n;
+
+    while(len){
+
+        n = write(fd, bytes, len);
+
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n <= 0)
+            return RT_FALSE;
+
+        bytes += n;
+        len -= n;
+    }
+    return RT_TRUE;
+}
+#endif
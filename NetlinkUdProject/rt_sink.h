@@ -0,0 +1,80 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_sink.h
+ *
+ *    Description:  Buffered sink the routing tables are dumped into
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:02:31 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_SINK__
+#define __RT_SINK__
+
+#include "rt_common.h"
+
+/* A dump is written into a caller supplied buffer, handed to write_fn
+ * each time it fills up, so the consumer sees a few large chunks, like
+ * a write() or a copy to user space each, rather than a call per route.
+ * Once write_fn fails the sink drops everything after*/
+
+/*Room for a dump of 1M routes in a few hundred chunks*/
+#define RT_SINK_BUF_SIZE    (64 * 1024)
+/*Longest piece rt_sink_printf() formats at once*/
+#define RT_SINK_MAX_PIECE   512
+
+/*RT_FALSE to abort the dump*/
+typedef rt_bool_t (*rt_sink_write_fn)(void *arg, const void *data, uint32_t len);
+
+typedef struct rt_sink_{
+
+    char *buf;
+    uint32_t size;          /*At least RT_SINK_MAX_PIECE*/
+    uint32_t len;
+    rt_bool_t failed;
+    rt_sink_write_fn write_fn;
+    void *arg;
+} rt_sink_t;
+
+void
+rt_sink_init(rt_sink_t *sink, char *buf, uint32_t size,
+             rt_sink_write_fn write_fn, void *arg);
+
+/*Hands what is buffered to write_fn. RT_FALSE if some write failed*/
+rt_bool_t
+rt_sink_flush(rt_sink_t *sink);
+
+void
+rt_sink_put(rt_sink_t *sink, const void *data, uint32_t len);
+
+void
+rt_sink_printf(rt_sink_t *sink, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+#ifndef __KERNEL__
+/*write_fn writing to the file descriptor arg points to*/
+rt_bool_t
+rt_sink_write_fd(void *arg, const void *data, uint32_t len);
+#endif
+
+#endif /* __RT_SINK__ */
@@ -0,0 +1,213 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_small.c
+ *
+ *    Description:  SIMD scan engine for small IPV4 routing tables
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 05:20:44 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_small.h"
+
+/* SIMD is left to user space, in the kernel the vector registers may
+ * only be used between kernel_fpu_begin()/end(), which costs more than
+ * a scan of RT_SMALL_MAX prefixes. AVX2 is picked at run time, SSE2 is
+ * always there on x86_64*/
+#if !defined(__KERNEL__) && defined(__x86_64__)
+#define RT_SMALL_X86
+#include <immintrin.h>
+#endif
+
+static rt_small_t *
+rt_small_alloc(uint32_t n){
+
+    uint32_t n_slots = (n + RT_SMALL_LANES - 1) & ~(RT_SMALL_LANES - 1);
+    rt_small_t *small = RT_CALLOC(sizeof(rt_small_t) +
+                            (n_slots * ((2 * sizeof(uint32_t)) + sizeof(void *))));
+    uint32_t i;
+
+    if(!small)
+        return NULL;
+
+    small->n = n;
+    small->n_slots = n_slots;
+
+    /*No address has bits outside of a zero mask*/
+    for(i = n; i < n_slots; i++)
+        rt_small_keys(small)[i] = 1;
+    return small;
+}
+
+static inline uint8_t
+rt_small_plen(const rt_small_t *small, uint32_t i){
+
+    return RT_POPCOUNT64(rt_small_masks(small)[i]);
+}
+
+/*Copies n prefixes of src from index from into dst at index to*/
+static void
+rt_small_copy(rt_small_t *dst, uint32_t to, const rt_small_t *src,
+              uint32_t from, uint32_t n){
+
+    memcpy(&rt_small_keys(dst)[to], &rt_small_keys(src)[from], n * sizeof(uint32_t));
+    memcpy(&rt_small_masks(dst)[to], &rt_small_masks(src)[from], n * sizeof(uint32_t));
+    memcpy(&rt_small_data(dst)[to], &rt_small_data(src)[from], n * sizeof(void *));
+}
+
+static void
+rt_small_set(rt_small_t *small, uint32_t i, uint32_t key, uint8_t plen, void *data){
+
+    rt_small_keys(small)[i] = key;
+    rt_small_masks(small)[i] = rt_ipv4_mask(plen);
+    rt_small_data(small)[i] = data;
+}
+
+rt_small_t *
+rt_small_build(const uint32_t *keys, const uint8_t *plens, void *const *data,
+               uint32_t n){
+
+    rt_small_t *small;
+    uint32_t i, j = 0;
+    int plen;
+
+    if(n > RT_SMALL_MAX || !(small = rt_small_alloc(n)))
+        return NULL;
+
+    /*Longest prefixes first*/
+    for(plen = RT_IPV4_MAX_MASK; plen >= 0; plen--){
+        for(i = 0; i < n; i++){
+            if(plens[i] == plen)
+                rt_small_set(small, j++, keys[i], plen, data[i]);
+        }
+    }
+    return small;
+}
+
+rt_small_t *
+rt_small_insert(const rt_small_t *small, uint32_t key, uint8_t plen, void *data){
+
+    rt_small_t *new_small;
+    uint32_t i;
+
+    if(small->n == RT_SMALL_MAX || !(new_small = rt_small_alloc(small->n + 1)))
+        return NULL;
+
+    /*After the prefixes as long or longer*/
+    for(i = 0; i < small->n && rt_small_plen(small, i) >= plen; i++);
+
+    rt_small_copy(new_small, 0, small, 0, i);
+    rt_small_set(new_small, i, key, plen, data);
+    rt_small_copy(new_small, i + 1, small, i, small->n - i);
+    return new_small;
+}
+
+rt_small_t *
+rt_small_delete(const rt_small_t *small, uint32_t key, uint8_t plen){
+
+    rt_small_t *new_small;
+    uint32_t mask = rt_ipv4_mask(plen), i;
+
+    for(i = 0; i < small->n; i++){
+        if(rt_small_keys(small)[i] == key && rt_small_masks(small)[i] == mask)
+            break;
+    }
+
+    /*Not present, a plain copy*/
+    if(i == small->n){
+        if((new_small = rt_small_alloc(small->n)))
+            rt_small_copy(new_small, 0, small, 0, small->n);
+        return new_small;
+    }
+
+    if(!(new_small = rt_small_alloc(small->n - 1)))
+        return NULL;
+
+    rt_small_copy(new_small, 0, small, 0, i);
+    rt_small_copy(new_small, i, small, i + 1, small->n - i - 1);
+    return new_small;
+}
+
+#ifdef RT_SMALL_X86
+__attribute__((target("avx2")))
+static void *
+rt_small_lookup_avx2(const rt_small_t *small, uint32_t addr){
+
+    const uint32_t *keys = rt_small_keys(small), *masks = rt_small_masks(small);
+    __m256i a = _mm256_set1_epi32((int)addr), eq;
+    uint32_t i;
+    int bits;
+
+    for(i = 0; i < small->n_slots; i += 8){
+
+        eq = _mm256_cmpeq_epi32(
+                _mm256_and_si256(a, _mm256_loadu_si256((const __m256i *)&masks[i])),
+                _mm256_loadu_si256((const __m256i *)&keys[i]));
+        bits = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+
+        if(bits)
+            return rt_small_data(small)[i + __builtin_ctz(bits)];
+    }
+    return NULL;
+}
+
+static void *
+rt_small_lookup_sse2(const rt_small_t *small, uint32_t addr){
+
+    const uint32_t *keys = rt_small_keys(small), *masks = rt_small_masks(small);
+    __m128i a = _mm_set1_epi32((int)addr), eq;
+    uint32_t i;
+    int bits;
+
+    for(i = 0; i < small->n_slots; i += 4){
+
+        eq = _mm_cmpeq_epi32(
+                _mm_and_si128(a, _mm_loadu_si128((const __m128i *)&masks[i])),
+                _mm_loadu_si128((const __m128i *)&keys[i]));
+        bits = _mm_movemask_ps(_mm_castsi128_ps(eq));
+
+        if(bits)
+            return rt_small_data(small)[i + __builtin_ctz(bits)];
+    }
+    return NULL;
+}
+#endif
+
+void *
+rt_small_lookup(const rt_small_t *small, uint32_t addr){
+
+#ifdef RT_SMALL_X86
+    if(__builtin_cpu_supports("avx2"))
+        return rt_small_lookup_avx2(small, addr);
+    return rt_small_lookup_sse2(small, addr);
+#else
+    const uint32_t *keys = rt_small_keys(small), *masks = rt_small_masks(small);
+    uint32_t i;
+
+    for(i = 0; i < small->n; i++){
+        if((addr & masks[i]) == keys[i])
+            return rt_small_data(small)[i];
+    }
+    return NULL;
+#endif
+}
@@ -0,0 +1,97 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_small.h
+ *
+ *    Description:  SIMD scan engine for small IPV4 routing tables
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 05:20:44 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_SMALL__
+#define __RT_SMALL__
+
+#include "rt_common.h"
+
+/* Engine for tables of a few IPV4 routes, where walking a trie chases
+ * more pointers than there are routes. The prefixes are kept in
+ * structure of arrays form, keys and masks in two arrays of 32 bit
+ * words, sorted by decreasing prefix length so that the first match is
+ * the longest one. A lookup compares the address against 8 (AVX2) or 4
+ * (SSE2) prefixes per instruction and stops at the first match, the
+ * kernel and other machines scan one prefix at a time.
+ *
+ * An rt_small_t is immutable : every change builds a new copy which the
+ * writer publishes, the old one going to RT_FREE_DEFERRED(). The arrays
+ * are padded to a multiple of RT_SMALL_LANES with prefixes which match
+ * no address*/
+
+#define RT_SMALL_MAX    256     /*Prefixes of an rt_small_t at most*/
+#define RT_SMALL_LANES  8
+
+typedef struct rt_small_{
+
+    uint32_t n;                 /*Prefixes*/
+    uint32_t n_slots;           /*n rounded up to RT_SMALL_LANES*/
+    /*keys[n_slots], masks[n_slots] then the data, void *[n_slots]*/
+    uint32_t words[];
+} rt_small_t;
+
+static inline uint32_t *
+rt_small_keys(const rt_small_t *small){
+
+    return (uint32_t *)small->words;
+}
+
+static inline uint32_t *
+rt_small_masks(const rt_small_t *small){
+
+    return (uint32_t *)small->words + small->n_slots;
+}
+
+static inline void **
+rt_small_data(const rt_small_t *small){
+
+    return (void **)((uint32_t *)small->words + (2 * small->n_slots));
+}
+
+/* Builds the engine out of n prefixes given in any order, keys in host
+ * byte order masked to plen. NULL if n > RT_SMALL_MAX or out of memory*/
+rt_small_t *
+rt_small_build(const uint32_t *keys, const uint8_t *plens, void *const *data,
+               uint32_t n);
+
+/* Copy of small with key/plen added, small being left as is since
+ * lookups may be reading it. NULL if small is full or out of memory*/
+rt_small_t *
+rt_small_insert(const rt_small_t *small, uint32_t key, uint8_t plen, void *data);
+
+/*Copy of small without key/plen, NULL if out of memory*/
+rt_small_t *
+rt_small_delete(const rt_small_t *small, uint32_t key, uint8_t plen);
+
+/*Longest prefix match, addr in host byte order*/
+void *
+rt_small_lookup(const rt_small_t *small, uint32_t addr);
+
+#endif /* __RT_SMALL__ */
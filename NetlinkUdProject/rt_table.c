@@ -0,0 +1,2345 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_table.c
+ *
+ *    Description:  This file contains the routing table code shared by the LKM and user
+ *                  space, each world plugs into it with rt_kern.c and rt_user.c
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:05:12 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifdef __KERNEL__
+#include <linux/in.h>       /*htonl*/
+#include <linux/socket.h>   /*AF_INET6*/
+#else
+#include <stdio.h>
+#include <arpa/inet.h>      /*htonl*/
+#include <unistd.h>         /*usleep*/
+#endif
+#include "rt.h"
+#include "rt_platform.h"
+
+/* Parses dest_ip/mask into its family and the address masked to mask
+ * in network byte order, which is the key used by the prefix index*/
+static rt_bool_t
+rt_prefix_parse(char *dest_ip, uint8_t mask,
+                uint8_t *family, uint8_t *addr){
+
+    uint32_t dest;
+
+    memset(addr, 0, RT_IPV6_ADDR_LEN);
+
+    if(rt_is_ipv6(dest_ip)){
+
+        if(mask > RT_IPV6_MAX_MASK || !rt_ipv6_pton(dest_ip, addr))
+            return RT_FALSE;
+
+        rt_addr_apply_mask(addr, RT_IPV6_ADDR_LEN, mask);
+        *family = AF_INET6;
+        return RT_TRUE;
+    }
+
+    if(mask > RT_IPV4_MAX_MASK || !rt_ipv4_pton(dest_ip, &dest))
+        return RT_FALSE;
+
+    dest = htonl(dest & rt_ipv4_mask(mask));
+    memcpy(addr, &dest, sizeof(dest));
+    *family = AF_INET;
+    return RT_TRUE;
+}
+
+/*Host byte order IPV4 address out of the prefix key*/
+static inline uint32_t
+rt_prefix_ipv4(const uint8_t *addr){
+
+    uint32_t dest;
+
+    memcpy(&dest, addr, sizeof(dest));
+    return ntohl(dest);
+}
+
+
+static void
+rt_table_changed(rt_table_t *rt_table);
+
+static const rt_engine_ops_t *const rt_engines[RT_ENGINE_MAX];
+
+static rt_bool_t
+__rt_table_set_engine(rt_table_t *rt_table, rt_engine_t engine, uint32_t param);
+
+/* Takes a reference on the next hop via gw_ip and oif. A gateway which
+ * is not an address, like "" for a directly connected route, is stored
+ * as all zeros*/
+static uint32_t
+rt_nexthop_get_text(rt_table_t *rt_table, char *gw_ip, char *oif){
+
+    uint32_t gw;
+    uint8_t gw_family = AF_INET;
+    uint8_t gw_addr[RT_IPV6_ADDR_LEN];
+
+    memset(gw_addr, 0, sizeof(gw_addr));
+
+    if(rt_is_ipv6(gw_ip)){
+        gw_family = AF_INET6;
+        if(!rt_ipv6_pton(gw_ip, gw_addr))
+            memset(gw_addr, 0, sizeof(gw_addr));
+    }
+    else if(rt_ipv4_pton(gw_ip, &gw)){
+        gw = htonl(gw);
+        memcpy(gw_addr, &gw, sizeof(gw));
+    }
+
+    return rt_nexthop_get(&rt_table->nexthops, gw_family, gw_addr, oif);
+}
+
+/*Points rt_entry to nh_id, a next hop or group it holds a reference on*/
+static void
+rt_entry_replace_nexthop(rt_table_t *rt_table, rt_entry_t *rt_entry,
+                         uint32_t nh_id, uint32_t ifindex){
+
+    if(rt_entry->nh_id != RT_NEXTHOP_INVALID_ID)
+        rt_nexthop_put(&rt_table->nexthops, rt_entry->nh_id);
+
+    /*Lookups may be reading the entry*/
+    RT_STORE(rt_entry->nh_id, nh_id);
+    RT_STORE(rt_entry->ifindex, ifindex);
+}
+
+/*Sets the gateway/oif of rt_entry*/
+static rt_bool_t
+rt_entry_set_nexthop(rt_table_t *rt_table, rt_entry_t *rt_entry,
+                     char *gw_ip, char *oif){
+
+    uint32_t nh_id = rt_nexthop_get_text(rt_table, gw_ip, oif);
+
+    if(nh_id == RT_NEXTHOP_INVALID_ID)
+        return RT_FALSE;
+
+    rt_entry_replace_nexthop(rt_table, rt_entry, nh_id,
+        rt_nexthop_lookup(&rt_table->nexthops, nh_id)->ifindex);
+    return RT_TRUE;
+}
+
+/* Sets the paths of rt_entry, through a next hop group if more than
+ * one, derived from the group it used so far*/
+static rt_bool_t
+rt_entry_set_paths(rt_table_t *rt_table, rt_entry_t *rt_entry,
+                   const rt_path_t *paths, uint32_t n_paths){
+
+    rt_nexthop_path_t nh_paths[RT_NEXTHOP_MAX_PATHS];
+    uint32_t i, n = 0, group_id = RT_NEXTHOP_INVALID_ID, ifindex;
+
+    if(n_paths == 1)
+        return rt_entry_set_nexthop(rt_table, rt_entry, paths[0].gw_ip,
+                    paths[0].oif);
+
+    if(!n_paths || n_paths > RT_NEXTHOP_MAX_PATHS)
+        return RT_FALSE;
+
+    for(; n < n_paths; n++){
+
+        nh_paths[n].nh_id = rt_nexthop_get_text(rt_table, paths[n].gw_ip,
+                                paths[n].oif);
+        nh_paths[n].weight = paths[n].weight;
+
+        if(nh_paths[n].nh_id == RT_NEXTHOP_INVALID_ID)
+            goto out;
+    }
+
+    group_id = rt_nexthop_group_get(&rt_table->nexthops, nh_paths, n, rt_entry->nh_id);
+
+    if(group_id != RT_NEXTHOP_INVALID_ID){
+        ifindex = rt_nexthop_lookup(&rt_table->nexthops, nh_paths[0].nh_id)->ifindex;
+        rt_entry_replace_nexthop(rt_table, rt_entry, group_id, ifindex);
+    }
+
+out:
+    /*The group holds its own references*/
+    for(i = 0; i < n; i++)
+        rt_nexthop_put(&rt_table->nexthops, nh_paths[i].nh_id);
+
+    return group_id != RT_NEXTHOP_INVALID_ID;
+}
+
+#ifdef __KERNEL__
+RT_POOL_DEFINE_RCU_FREE(rt_entry_free_rcu, rt_entry_t, rcu)
+#else
+/*Called with the table locked, from rt_table_unlock()*/
+static void
+rt_entry_retired(void *arg, void *ptr){
+
+    rt_pool_free((rt_pool_t *)arg, ptr);
+}
+#endif
+
+static void
+rt_entry_free(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    if(rt_entry->nh_id != RT_NEXTHOP_INVALID_ID)
+        rt_nexthop_put(&rt_table->nexthops, rt_entry->nh_id);
+
+    if(rt_entry->cold_id != RT_COLD_INVALID_ID)
+        rt_cold_free(&rt_table->cold, rt_entry->cold_id);
+
+#ifdef __KERNEL__
+    rt_pool_free_rcu(&rt_table->entry_pool, rt_entry, rcu, rt_entry_free_rcu);
+#else
+    rt_epoch_retire(&rt_table->limbo, rt_entry, rt_entry_retired,
+        &rt_table->entry_pool);
+#endif
+}
+
+static inline uint64_t *
+rt_prefix_len_word(rt_prefix_index_t *prefix_index, uint8_t family, uint8_t mask){
+
+    return family == AF_INET ? &prefix_index->len_bmp4 :
+                &prefix_index->len_bmp6[mask / 64];
+}
+
+static inline rt_bool_t
+rt_prefix_len_present(rt_prefix_index_t *prefix_index, uint8_t family, uint8_t mask){
+
+    return (*rt_prefix_len_word(prefix_index, family, mask) & (1ULL << (mask % 64))) ?
+                RT_TRUE : RT_FALSE;
+}
+
+static inline rt_prefix_hash_t **
+rt_prefix_hash_slot(rt_prefix_index_t *prefix_index, uint8_t family, uint8_t mask){
+
+    return family == AF_INET ? &prefix_index->hash4[mask] :
+                &prefix_index->hash6[mask];
+}
+
+/*Exact match of a parsed prefix, the lengths bitmap saves probing the
+ * hash tables of the prefix lengths which are not in use*/
+static rt_entry_t *
+rt_prefix_index_lookup(rt_table_t *rt_table, uint8_t family,
+                       uint8_t *addr, uint8_t mask){
+
+    if(!rt_prefix_len_present(&rt_table->prefix_index, family, mask))
+        return NULL;
+
+    return rt_prefix_hash_lookup(
+            *rt_prefix_hash_slot(&rt_table->prefix_index, family, mask),
+            family, addr);
+}
+
+static rt_bool_t
+rt_prefix_index_add(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    rt_prefix_index_t *prefix_index = &rt_table->prefix_index;
+    rt_prefix_hash_t **hash = rt_prefix_hash_slot(prefix_index,
+                                rt_entry->family, rt_entry->mask);
+
+    if(!*hash && !(*hash = rt_prefix_hash_create(rt_entry->family)))
+        return RT_FALSE;
+
+    if(!rt_prefix_hash_insert(*hash, rt_entry))
+        return RT_FALSE;
+
+    *rt_prefix_len_word(prefix_index, rt_entry->family, rt_entry->mask) |=
+        (1ULL << (rt_entry->mask % 64));
+    return RT_TRUE;
+}
+
+static void
+rt_prefix_index_delete(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    rt_prefix_index_t *prefix_index = &rt_table->prefix_index;
+    rt_prefix_hash_t *hash = *rt_prefix_hash_slot(prefix_index,
+                                rt_entry->family, rt_entry->mask);
+
+    if(!rt_prefix_hash_remove(hash, rt_entry))
+        *rt_prefix_len_word(prefix_index, rt_entry->family, rt_entry->mask) &=
+            ~(1ULL << (rt_entry->mask % 64));
+}
+
+/* Publishes the new copy of the small table engine. NULL once the table
+ * outgrew it or out of memory, the lookups fall back to the trie*/
+static void
+rt_table_small_replace(rt_table_t *rt_table, rt_small_t *small){
+
+    rt_small_t *old = rt_table->small4;
+
+    RT_PUBLISH(rt_table->small4, small);
+    if(old)
+        RT_FREE_DEFERRED(old);
+}
+
+/*Back to the small table engine once the IPV4 routes are few again*/
+static void
+rt_table_small_sync(rt_table_t *rt_table){
+
+    glthread_t *curr;
+    rt_entry_t *rt_entry = NULL;
+    uint32_t n = 0, *keys;
+    uint8_t *plens;
+    void **data;
+
+    if(rt_table->small4 || rt_table->trie.n_prefixes > RT_SMALL_MAX / 2)
+        return;
+
+    keys = RT_CALLOC((RT_SMALL_MAX / 2) *
+                (sizeof(uint32_t) + sizeof(uint8_t) + sizeof(void *)));
+
+    if(!keys)
+        return;
+
+    data = (void **)(keys + (RT_SMALL_MAX / 2));
+    plens = (uint8_t *)(data + (RT_SMALL_MAX / 2));
+
+    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+        rt_entry = rt_entry_glue_to_rt_entry(curr);
+
+        if(rt_entry->family != AF_INET)
+            continue;
+
+        keys[n] = rt_prefix_ipv4(rt_entry->dest_addr);
+        plens[n] = rt_entry->mask;
+        data[n++] = rt_entry;
+    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+    rt_table_small_replace(rt_table, rt_small_build(keys, plens, data, n));
+    RT_FREE(keys);
+}
+
+/*Keep the engine of the IPV4 lookups in sync with the trie*/
+static inline void
+rt_ipv4_engines_add(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    if(rt_table->engine->add)
+        rt_table->engine->add(rt_table, rt_entry);
+}
+
+static inline void
+rt_ipv4_engines_delete(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    if(rt_table->engine->remove)
+        rt_table->engine->remove(rt_table, rt_entry);
+}
+
+/* Compresses the n routes of a snapshot in place, labels telling their
+ * next hops apart. They are left as is if they do not compress*/
+static uint32_t
+rt_table_fib_compress(rt_fib_result_t *routes, const uint32_t *labels, uint32_t n){
+
+    rt_fib_result_t *compressed = RT_CALLOC_LARGE(((uint64_t)n + 1) *
+                                    sizeof(rt_fib_result_t));
+    uint32_t n_compressed;
+
+    if(!compressed)
+        return n;
+
+    n_compressed = rt_ortc_compress(routes, labels, n, compressed);
+
+    if(n_compressed){
+        memcpy(routes, compressed, (uint64_t)n_compressed * sizeof(rt_fib_result_t));
+        n = n_compressed;
+    }
+    RT_FREE_LARGE(compressed);
+    return n;
+}
+
+/*Snapshot of the routes of the table, NULL if out of memory*/
+static rt_fib_t *
+__rt_table_fib_build(rt_table_t *rt_table){
+
+    glthread_t *curr;
+    rt_entry_t *rt_entry = NULL;
+    rt_nexthop_t *nh;
+    rt_fib_result_t *routes, *route;
+    rt_fib_t *fib;
+    uint32_t *labels = NULL;
+    uint32_t n = 0;
+
+    /*The pool counts every live route, and possibly some retired ones*/
+    routes = RT_CALLOC_LARGE(((uint64_t)rt_table->entry_pool.n_objs + 1) *
+                sizeof(rt_fib_result_t));
+    if(!routes)
+        return NULL;
+
+    /*Routes via the same next hop get the same label, its id*/
+    if(rt_table->fib_compress)
+        labels = RT_CALLOC_LARGE(((uint64_t)rt_table->entry_pool.n_objs + 1) *
+                    sizeof(uint32_t));
+
+    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+        rt_entry = rt_entry_glue_to_rt_entry(curr);
+        /*A snapshot holds one path per route*/
+        nh = rt_nexthop_select(&rt_table->nexthops, rt_entry->nh_id, 0);
+        route = &routes[n++];
+
+        memcpy(route->dest_addr, rt_entry->dest_addr, sizeof(route->dest_addr));
+        memcpy(route->gw_addr, nh->gw_addr, sizeof(route->gw_addr));
+        route->ifindex = nh->ifindex;
+        route->mask = rt_entry->mask;
+        route->family = rt_entry->family;
+        route->gw_family = nh->family;
+        if(labels)
+            labels[n - 1] = (uint32_t)(nh - rt_table->nexthops.nexthops);
+    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+    if(labels){
+        n = rt_table_fib_compress(routes, labels, n);
+        RT_FREE_LARGE(labels);
+    }
+
+    fib = rt_fib_build(routes, n, rt_table->generation);
+    RT_FREE_LARGE(routes);
+    return fib;
+}
+
+static rt_bool_t
+__rt_table_fib_compile(rt_table_t *rt_table){
+
+    rt_fib_t *fib = __rt_table_fib_build(rt_table), *old_fib;
+
+    if(!fib)
+        return RT_FALSE;
+
+    old_fib = rt_table->fib;
+    RT_PUBLISH(rt_table->fib, fib);
+    RT_FREE_DEFERRED(old_fib);
+    return RT_TRUE;
+}
+
+#ifdef __KERNEL__
+static void
+rt_fib_work_fn(struct work_struct *work){
+
+    rt_table_t *rt_table = container_of(to_delayed_work(work), rt_table_t, fib_work);
+
+    rt_table_lock(rt_table);
+    if(rt_table->fib && rt_table->fib->generation != rt_table->generation &&
+        !__rt_table_fib_compile(rt_table))
+        rt_log("%s(): FIB snapshot compilation failed\n", __FUNCTION__);
+    rt_table_unlock(rt_table);
+}
+#else
+static void *
+rt_fib_thread_fn(void *arg){
+
+    rt_table_t *rt_table = arg;
+    uint32_t debounce_ms;
+
+    pthread_mutex_lock(&rt_table->lock);
+
+    while((debounce_ms = rt_table->fib_debounce_ms)){
+
+        if(!rt_table->fib_dirty){
+            pthread_cond_wait(&rt_table->fib_cond, &rt_table->lock);
+            continue;
+        }
+
+        /*Let the changes of the next debounce_ms pile up*/
+        pthread_mutex_unlock(&rt_table->lock);
+        usleep(debounce_ms * 1000);
+
+        rt_table_lock(rt_table);
+        rt_table->fib_dirty = RT_FALSE;
+        if(rt_table->fib_debounce_ms && !__rt_table_fib_compile(rt_table))
+            rt_log("%s(): FIB snapshot compilation failed\n", __FUNCTION__);
+        rt_table_unlock(rt_table);
+
+        pthread_mutex_lock(&rt_table->lock);
+    }
+
+    pthread_mutex_unlock(&rt_table->lock);
+    return NULL;
+}
+#endif
+
+/* Records a change of rt_entry, NULL for RT_JOURNAL_CLEAR, in the
+ * journal if enabled. The change becomes visible, and the generation
+ * it is recorded at current, at the next rt_table_changed()*/
+static void
+rt_table_journal(rt_table_t *rt_table, rt_journal_op_t op, rt_entry_t *rt_entry){
+
+    rt_journal_rec_t *rec;
+    rt_nexthop_t *nh;
+
+    if(!rt_table->journal)
+        return;
+
+    rec = rt_journal_append(rt_table->journal, rt_table->generation + 1);
+    rec->op = op;
+
+    if(!rt_entry)
+        return;
+
+    memcpy(rec->dest_addr, rt_entry->dest_addr, sizeof(rec->dest_addr));
+    rec->mask = rt_entry->mask;
+    rec->family = rt_entry->family;
+
+    if(op == RT_JOURNAL_DELETE)
+        return;
+
+    nh = rt_nexthop_select(&rt_table->nexthops, rt_entry->nh_id, 0);
+    memcpy(rec->gw_addr, nh->gw_addr, sizeof(rec->gw_addr));
+    rec->gw_family = nh->family;
+    rec->ifindex = nh->ifindex;
+}
+
+/*Called with the table locked after every change of the routes*/
+static void
+rt_table_changed(rt_table_t *rt_table){
+
+    /*Once the change is visible, see rt_cache_lookup()*/
+    RT_STORE_RELEASE(rt_table->generation, rt_table->generation + 1);
+
+    if(rt_table->engine->changed)
+        rt_table->engine->changed(rt_table);
+
+    if(!rt_table->fib || !rt_table->fib_debounce_ms)
+        return;
+#ifdef __KERNEL__
+    /*No-op if already pending, the changes until it runs are batched*/
+    schedule_delayed_work(&rt_table->fib_work,
+        msecs_to_jiffies(rt_table->fib_debounce_ms));
+#else
+    rt_table->fib_dirty = RT_TRUE;
+    pthread_cond_signal(&rt_table->fib_cond);
+#endif
+}
+
+void
+rt_init_rt_table(rt_table_t *rt_table){
+
+#ifdef __KERNEL__
+    mutex_init(&rt_table->lock);
+#else
+    pthread_mutex_init(&rt_table->lock, NULL);
+    rt_epoch_limbo_init(&rt_table->limbo);
+#endif
+    init_glthread(&rt_table->head);
+    rt_pool_init(&rt_table->entry_pool, "rt_entry", sizeof(rt_entry_t));
+    rt_nexthop_table_init(&rt_table->nexthops);
+    rt_cold_table_init(&rt_table->cold);
+    memset(&rt_table->prefix_index, 0, sizeof(rt_table->prefix_index));
+    rt_trie_init(&rt_table->trie);
+    rt_tbm_init(&rt_table->tbm6, RT_IPV6_MAX_MASK);
+    rt_table->small4 = NULL;
+    rt_table->dir24_8 = NULL;
+    rt_table->tbm4 = NULL;
+    rt_table->interval4 = NULL;
+    rt_table->engine = rt_engines[RT_ENGINE_LIST];
+    rt_table->generation = 0;
+    rt_table->journal = NULL;
+    rt_table->counters = NULL;
+    rt_table->fib = NULL;
+    rt_table->fib_debounce_ms = 0;
+    rt_table->fib_compress = RT_FALSE;
+#ifdef __KERNEL__
+    INIT_DELAYED_WORK(&rt_table->fib_work, rt_fib_work_fn);
+#else
+    pthread_cond_init(&rt_table->fib_cond, NULL);
+    rt_table->fib_dirty = RT_FALSE;
+    rt_table->fib_thread_running = RT_FALSE;
+#endif
+}
+
+/* Fills a new rt_entry for the parsed prefix and adds it to the prefix
+ * index, rt_entry is freed on failure*/
+static rt_bool_t
+rt_entry_setup(rt_table_t *rt_table, rt_entry_t *rt_entry,
+               uint8_t family, uint8_t *dest, uint8_t mask,
+               char *dest_ip, char *gw_ip, char *oif){
+
+    memcpy(rt_entry->dest_addr, dest, sizeof(rt_entry->dest_addr));
+    rt_entry->mask = mask;
+    rt_entry->family = family;
+    rt_entry->nh_id = RT_NEXTHOP_INVALID_ID;
+    rt_entry->cold_id = rt_cold_alloc(&rt_table->cold);
+
+    init_glthread(&rt_entry->rt_entry_glue);
+
+    if(rt_entry->cold_id == RT_COLD_INVALID_ID ||
+        !rt_entry_set_nexthop(rt_table, rt_entry, gw_ip, oif)){
+        rt_entry_free(rt_table, rt_entry);
+        return RT_FALSE;
+    }
+
+    if(rt_table->counters)
+        rt_counters_reset(rt_table->counters, rt_entry->cold_id);
+
+    strncpy(rt_cold_get(&rt_table->cold, rt_entry->cold_id)->dest_ip, dest_ip,
+        RT_IP_ADDR_STRLEN - 1);
+
+    if(!rt_prefix_index_add(rt_table, rt_entry)){
+        rt_entry_free(rt_table, rt_entry);
+        return RT_FALSE;
+    }
+    return RT_TRUE;
+}
+
+/*Fails only if out of memory to copy the tree bitmap nodes*/
+static rt_bool_t
+rt_entry_delete(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    if(rt_entry->family == AF_INET6 &&
+        !rt_tbm_delete(&rt_table->tbm6, rt_entry->dest_addr, rt_entry->mask))
+        return RT_FALSE;
+
+    rt_table_journal(rt_table, RT_JOURNAL_DELETE, rt_entry);
+    rt_prefix_index_delete(rt_table, rt_entry);
+
+    if(rt_entry->family == AF_INET){
+        rt_trie_delete(&rt_table->trie, rt_prefix_ipv4(rt_entry->dest_addr),
+            rt_entry->mask);
+        rt_ipv4_engines_delete(rt_table, rt_entry);
+    }
+
+    /*No lookup can find the entry anymore, the ones in flight may still
+     * hold it, rt_entry_free() takes care of them*/
+    remove_glthread(&rt_entry->rt_entry_glue);
+    rt_entry_free(rt_table, rt_entry);
+    return RT_TRUE;
+}
+
+static rt_bool_t
+__rt_add_multipath_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask, const rt_path_t *paths, uint32_t n_paths){
+
+    uint8_t family;
+    uint8_t dest[RT_IPV6_ADDR_LEN];
+    rt_bool_t rc;
+    rt_entry_t *rt_entry = NULL;
+
+    if(!rt_prefix_parse(dest_ip, mask, &family, dest))
+        return RT_FALSE;
+
+    /*Duplicate*/
+    if(rt_prefix_index_lookup(rt_table, family, dest, mask))
+        return RT_FALSE;
+
+    if(!n_paths || n_paths > RT_NEXTHOP_MAX_PATHS)
+        return RT_FALSE;
+
+    rt_entry = rt_pool_alloc(&rt_table->entry_pool);
+
+    if(!rt_entry || !rt_entry_setup(rt_table, rt_entry, family, dest, mask,
+                        dest_ip, paths[0].gw_ip, paths[0].oif))
+        return RT_FALSE;
+
+    if(n_paths > 1)
+        rc = rt_entry_set_paths(rt_table, rt_entry, paths, n_paths);
+    else
+        rc = RT_TRUE;
+
+    if(rc && family == AF_INET6)
+        rc = rt_tbm_insert(&rt_table->tbm6, dest, mask, rt_entry);
+    else if(rc)
+        rc = rt_trie_insert(&rt_table->trie, rt_prefix_ipv4(dest), mask, rt_entry);
+
+    if(!rc){
+        rt_prefix_index_delete(rt_table, rt_entry);
+        rt_entry_free(rt_table, rt_entry);
+        return RT_FALSE;
+    }
+
+    glthread_add_next(&rt_table->head, &rt_entry->rt_entry_glue);
+
+    if(family == AF_INET)
+        rt_ipv4_engines_add(rt_table, rt_entry);
+    rt_table_journal(rt_table, RT_JOURNAL_ADD, rt_entry);
+    return RT_TRUE;
+}
+
+rt_bool_t
+rt_add_multipath_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask, const rt_path_t *paths, uint32_t n_paths){
+
+    rt_bool_t rc;
+
+    rt_table_lock(rt_table);
+    rc = __rt_add_multipath_rt_entry(rt_table, dest_ip, mask, paths, n_paths);
+    if(rc)
+        rt_table_changed(rt_table);
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+rt_bool_t
+rt_add_new_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask, char *gw_ip, char *oif){
+
+    rt_path_t path = {gw_ip, oif, 1};
+
+    return rt_add_multipath_rt_entry(rt_table, dest_ip, mask, &path, 1);
+}
+
+static rt_bool_t
+__rt_delete_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask){
+
+    uint8_t family;
+    uint8_t dest[RT_IPV6_ADDR_LEN];
+    rt_entry_t *rt_entry = NULL;
+
+    if(!rt_prefix_parse(dest_ip, mask, &family, dest))
+        return RT_FALSE;
+
+    rt_entry = rt_prefix_index_lookup(rt_table, family, dest, mask);
+
+    if(!rt_entry)
+        return RT_FALSE;
+
+    return rt_entry_delete(rt_table, rt_entry);
+}
+
+rt_bool_t
+rt_delete_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask){
+
+    rt_bool_t rc;
+
+    rt_table_lock(rt_table);
+    rc = __rt_delete_rt_entry(rt_table, dest_ip, mask);
+    if(rc)
+        rt_table_changed(rt_table);
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+static rt_bool_t
+__rt_update_multipath_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask, const rt_path_t *paths, uint32_t n_paths){
+
+    uint8_t family;
+    uint8_t dest[RT_IPV6_ADDR_LEN];
+    rt_entry_t *rt_entry = NULL;
+
+    if(!rt_prefix_parse(dest_ip, mask, &family, dest))
+        return RT_FALSE;
+
+    rt_entry = rt_prefix_index_lookup(rt_table, family, dest, mask);
+
+    if(!rt_entry)
+        return RT_FALSE;
+
+    /*The prefix does not change, hence neither do the lookup structures*/
+    if(!rt_entry_set_paths(rt_table, rt_entry, paths, n_paths))
+        return RT_FALSE;
+
+    rt_table_journal(rt_table, RT_JOURNAL_UPDATE, rt_entry);
+    return RT_TRUE;
+}
+
+rt_bool_t
+rt_update_multipath_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask, const rt_path_t *paths, uint32_t n_paths){
+
+    rt_bool_t rc;
+
+    rt_table_lock(rt_table);
+    rc = __rt_update_multipath_rt_entry(rt_table, dest_ip, mask, paths, n_paths);
+    if(rc)
+        rt_table_changed(rt_table);
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+rt_bool_t
+rt_update_rt_entry(rt_table_t *rt_table,
+    char *dest_ip, char mask, 
+    char *new_gw_ip, char *new_oif){
+
+    rt_path_t path = {new_gw_ip, new_oif, 1};
+
+    return rt_update_multipath_rt_entry(rt_table, dest_ip, mask, &path, 1);
+}
+
+/*A parsed route of rt_bulk_load()*/
+typedef struct rt_bulk_prefix_{
+
+    uint8_t dest[RT_IPV6_ADDR_LEN];
+    uint8_t family;
+    uint8_t mask;
+    uint32_t idx;       /*Of the route passed in*/
+} rt_bulk_prefix_t;
+
+/* Order of the trie, network byte order compares as the key does. Ties
+ * go by the order the routes were passed in, the first duplicate wins
+ * as with rt_add_new_rt_entry()*/
+static int
+rt_bulk_prefix_cmp(const void *a, const void *b){
+
+    const rt_bulk_prefix_t *pa = a, *pb = b;
+    int rc;
+
+    if(pa->family != pb->family)
+        return pa->family < pb->family ? -1 : 1;
+
+    rc = memcmp(pa->dest, pb->dest, RT_IPV6_ADDR_LEN);
+    if(rc)
+        return rc;
+
+    if(pa->mask != pb->mask)
+        return pa->mask < pb->mask ? -1 : 1;
+
+    return pa->idx < pb->idx ? -1 : (pa->idx > pb->idx);
+}
+
+static inline rt_bool_t
+rt_bulk_prefix_same(const rt_bulk_prefix_t *pa, const rt_bulk_prefix_t *pb){
+
+    return pa->family == pb->family && pa->mask == pb->mask &&
+            !memcmp(pa->dest, pb->dest, RT_IPV6_ADDR_LEN) ? RT_TRUE : RT_FALSE;
+}
+
+/*Sizes the hash of family/mask once for n more entries*/
+static void
+rt_prefix_index_reserve(rt_table_t *rt_table, uint8_t family, uint8_t mask,
+                        uint32_t n){
+
+    rt_prefix_hash_t **hash = rt_prefix_hash_slot(&rt_table->prefix_index,
+                                family, mask);
+
+    if(!*hash && !(*hash = rt_prefix_hash_create(family)))
+        return;
+
+    rt_prefix_hash_reserve(*hash, family, n);
+}
+
+/*Builds the trie out of the IPV4 prefixes of an empty table in one pass*/
+static rt_bool_t
+rt_bulk_build_trie(rt_table_t *rt_table, rt_bulk_prefix_t *prefixes,
+                   rt_entry_t **rt_entries, uint32_t n){
+
+    rt_trie_prefix_t *trie_prefixes;
+    uint32_t i, n_trie = 0;
+    rt_bool_t rc;
+
+    if(rt_table->trie.root)
+        return RT_FALSE;
+
+    trie_prefixes = RT_CALLOC_LARGE((uint64_t)n * sizeof(rt_trie_prefix_t));
+
+    if(!trie_prefixes)
+        return RT_FALSE;
+
+    for(i = 0; i < n; i++){
+
+        if(!rt_entries[i] || prefixes[i].family != AF_INET)
+            continue;
+
+        trie_prefixes[n_trie].key = rt_prefix_ipv4(prefixes[i].dest);
+        trie_prefixes[n_trie].plen = prefixes[i].mask;
+        trie_prefixes[n_trie].data = rt_entries[i];
+        n_trie++;
+    }
+
+    rc = rt_trie_build(&rt_table->trie, trie_prefixes, n_trie);
+    RT_FREE_LARGE(trie_prefixes);
+    return rc;
+}
+
+static uint32_t
+__rt_bulk_load(rt_table_t *rt_table, const rt_bulk_entry_t *routes, uint32_t n){
+
+    rt_bulk_prefix_t *prefixes, *prefix;
+    const rt_bulk_entry_t *route;
+    rt_entry_t **rt_entries = NULL;
+    rt_entry_t *rt_entry;
+    uint32_t i, n_prefixes = 0, n_new = 0, n_added = 0;
+    rt_bool_t sorted = RT_TRUE, trie_built, rc;
+    uint32_t counts[2][RT_IPV6_MAX_MASK + 1];
+
+    if(!n)
+        return 0;
+
+    prefixes = RT_CALLOC_LARGE((uint64_t)n * sizeof(rt_bulk_prefix_t));
+
+    if(!prefixes)
+        return 0;
+
+    for(i = 0; i < n; i++){
+
+        prefix = &prefixes[n_prefixes];
+
+        if(!rt_prefix_parse(routes[i].dest_ip, routes[i].mask,
+                &prefix->family, prefix->dest))
+            continue;
+
+        prefix->mask = routes[i].mask;
+        prefix->idx = i;
+
+        if(n_prefixes && rt_bulk_prefix_cmp(prefix - 1, prefix) > 0)
+            sorted = RT_FALSE;
+        n_prefixes++;
+    }
+
+    if(!sorted)
+        RT_SORT(prefixes, n_prefixes, sizeof(rt_bulk_prefix_t), rt_bulk_prefix_cmp);
+
+    /*Drop the duplicates, of the routes passed in or of the table*/
+    for(i = 0; i < n_prefixes; i++){
+
+        prefix = &prefixes[i];
+
+        if((n_new && rt_bulk_prefix_same(&prefixes[n_new - 1], prefix)) ||
+            rt_prefix_index_lookup(rt_table, prefix->family, prefix->dest,
+                prefix->mask))
+            continue;
+
+        prefixes[n_new++] = *prefix;
+    }
+
+    rt_entries = RT_CALLOC_LARGE((uint64_t)(n_new + 1) * sizeof(rt_entry_t *));
+
+    if(!rt_entries ||
+        !rt_pool_alloc_bulk(&rt_table->entry_pool, n_new, (void **)rt_entries))
+        goto out;
+
+    memset(counts, 0, sizeof(counts));
+    for(i = 0; i < n_new; i++)
+        counts[prefixes[i].family == AF_INET6][prefixes[i].mask]++;
+
+    for(i = 0; i <= RT_IPV6_MAX_MASK; i++){
+        if(i <= RT_IPV4_MAX_MASK && counts[0][i])
+            rt_prefix_index_reserve(rt_table, AF_INET, i, counts[0][i]);
+        if(counts[1][i])
+            rt_prefix_index_reserve(rt_table, AF_INET6, i, counts[1][i]);
+    }
+
+    for(i = 0; i < n_new; i++){
+
+        prefix = &prefixes[i];
+        route = &routes[prefix->idx];
+
+        if(!rt_entry_setup(rt_table, rt_entries[i], prefix->family,
+                prefix->dest, prefix->mask, route->dest_ip, route->gw_ip,
+                route->oif))
+            rt_entries[i] = NULL;
+    }
+
+    /*Inserting one by one remains if the table is not empty*/
+    trie_built = rt_bulk_build_trie(rt_table, prefixes, rt_entries, n_new);
+
+    for(i = 0; i < n_new; i++){
+
+        rt_entry = rt_entries[i];
+
+        if(!rt_entry)
+            continue;
+
+        if(rt_entry->family == AF_INET6)
+            rc = rt_tbm_insert(&rt_table->tbm6, rt_entry->dest_addr,
+                    rt_entry->mask, rt_entry);
+        else
+            rc = trie_built || rt_trie_insert(&rt_table->trie,
+                    rt_prefix_ipv4(rt_entry->dest_addr), rt_entry->mask, rt_entry);
+
+        if(!rc){
+            rt_prefix_index_delete(rt_table, rt_entry);
+            rt_entry_free(rt_table, rt_entry);
+            continue;
+        }
+
+        glthread_add_next(&rt_table->head, &rt_entry->rt_entry_glue);
+
+        if(rt_entry->family == AF_INET)
+            rt_ipv4_engines_add(rt_table, rt_entry);
+        rt_table_journal(rt_table, RT_JOURNAL_ADD, rt_entry);
+        n_added++;
+    }
+
+out:
+    RT_FREE_LARGE(rt_entries);
+    RT_FREE_LARGE(prefixes);
+    return n_added;
+}
+
+uint32_t
+rt_bulk_load(rt_table_t *rt_table, const rt_bulk_entry_t *routes, uint32_t n){
+
+    uint32_t n_added;
+
+    rt_table_lock(rt_table);
+    n_added = __rt_bulk_load(rt_table, routes, n);
+    if(n_added)
+        rt_table_changed(rt_table);
+    rt_table_unlock(rt_table);
+    return n_added;
+}
+
+static void
+rt_prefix_index_destroy(rt_prefix_index_t *prefix_index){
+
+    uint32_t i;
+    rt_prefix_hash_t *hash;
+
+    for(i = 0; i <= RT_IPV6_MAX_MASK; i++){
+
+        hash = i <= RT_IPV4_MAX_MASK ? prefix_index->hash4[i] : NULL;
+        if(hash){
+            rt_prefix_hash_destroy(hash);
+        }
+
+        hash = prefix_index->hash6[i];
+        if(hash){
+            rt_prefix_hash_destroy(hash);
+        }
+    }
+    memset(prefix_index, 0, sizeof(rt_prefix_index_t));
+}
+
+/*What rt_clear_rt_table() detaches from the table, freed in the background*/
+typedef struct rt_table_dead_{
+
+    glthread_t head;
+    rt_pool_t entry_pool;
+    rt_cold_table_t cold;
+    rt_prefix_index_t prefix_index;
+    rt_trie_t trie;
+    rt_tbm_t tbm6;
+    rt_small_t *small4;
+    rt_dir24_8_t *dir24_8;
+    rt_tbm_t *tbm4;
+    rt_interval_t *interval4;
+#ifdef __KERNEL__
+    struct rcu_work rwork;
+#else
+    rt_epoch_limbo_t limbo;
+#endif
+} rt_table_dead_t;
+
+/*No lookup may be running on dead anymore*/
+static void
+rt_table_dead_destroy(rt_table_dead_t *dead){
+
+#ifdef __KERNEL__
+    glthread_t *curr;
+
+    /*A slab cache goes only once its objects did*/
+    ITERATE_GLTHREAD_BEGIN(&dead->head, curr){
+
+        rt_pool_free(&dead->entry_pool, rt_entry_glue_to_rt_entry(curr));
+    } ITERATE_GLTHREAD_END(&dead->head, curr);
+#else
+    rt_epoch_limbo_destroy(&dead->limbo);
+#endif
+
+    /*In user space, the whole arena of routes at once*/
+    rt_pool_destroy(&dead->entry_pool);
+    rt_cold_table_destroy(&dead->cold);
+    rt_prefix_index_destroy(&dead->prefix_index);
+    rt_trie_destroy(&dead->trie);
+    rt_tbm_destroy(&dead->tbm6);
+
+    if(dead->small4)
+        RT_FREE(dead->small4);
+
+    if(dead->dir24_8)
+        rt_dir24_8_destroy(dead->dir24_8);
+
+    if(dead->tbm4){
+        rt_tbm_destroy(dead->tbm4);
+        RT_FREE(dead->tbm4);
+    }
+
+    if(dead->interval4)
+        rt_interval_free(dead->interval4);
+    RT_FREE(dead);
+}
+
+#ifdef __KERNEL__
+/* Created with the first flush, rt_reclaim_barrier() destroys it so
+ * that no work is left running once the module is gone*/
+static struct workqueue_struct *rt_reclaim_wq;
+static DEFINE_MUTEX(rt_reclaim_mutex);
+
+static void
+rt_table_dead_work_fn(struct work_struct *work){
+
+    rt_table_dead_destroy(container_of(to_rcu_work(work), rt_table_dead_t, rwork));
+}
+#else
+static void
+rt_table_dead_take_limbo(rt_table_t *rt_table, rt_table_dead_t *dead){
+
+    uint32_t i;
+    rt_epoch_deferred_t *item;
+
+    dead->limbo = rt_table->limbo;
+    rt_epoch_limbo_init(&rt_table->limbo);
+
+    for(i = 0; i < dead->limbo.n_items; i++){
+        item = &dead->limbo.items[i];
+        if(item->free_fn == rt_entry_retired)
+            item->arg = &dead->entry_pool;
+    }
+}
+
+static pthread_mutex_t rt_reclaim_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rt_reclaim_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t rt_reclaim_pending;
+
+static void *
+rt_table_dead_thread_fn(void *arg){
+
+    rt_epoch_synchronize();
+    rt_table_dead_destroy(arg);
+
+    pthread_mutex_lock(&rt_reclaim_mutex);
+    if(!--rt_reclaim_pending)
+        pthread_cond_broadcast(&rt_reclaim_cond);
+    pthread_mutex_unlock(&rt_reclaim_mutex);
+    return NULL;
+}
+#endif
+
+static void
+rt_table_dead_free(rt_table_dead_t *dead){
+
+#ifdef __KERNEL__
+    rt_bool_t queued = RT_FALSE;
+
+    mutex_lock(&rt_reclaim_mutex);
+
+    if(!rt_reclaim_wq)
+        rt_reclaim_wq = alloc_workqueue("rt_reclaim", WQ_UNBOUND, 0);
+
+    if(rt_reclaim_wq){
+        /*Runs once the grace period is over*/
+        INIT_RCU_WORK(&dead->rwork, rt_table_dead_work_fn);
+        queue_rcu_work(rt_reclaim_wq, &dead->rwork);
+        queued = RT_TRUE;
+    }
+
+    mutex_unlock(&rt_reclaim_mutex);
+
+    if(queued)
+        return;
+#else
+    pthread_t thread;
+
+    pthread_mutex_lock(&rt_reclaim_mutex);
+    rt_reclaim_pending++;
+    pthread_mutex_unlock(&rt_reclaim_mutex);
+
+    if(pthread_create(&thread, NULL, rt_table_dead_thread_fn, dead) == 0){
+        pthread_detach(thread);
+        return;
+    }
+
+    pthread_mutex_lock(&rt_reclaim_mutex);
+    rt_reclaim_pending--;
+    pthread_mutex_unlock(&rt_reclaim_mutex);
+#endif
+
+    /*Nothing to free it in the background*/
+    RT_SYNCHRONIZE();
+    rt_table_dead_destroy(dead);
+}
+
+void
+rt_reclaim_barrier(void){
+
+#ifdef __KERNEL__
+    mutex_lock(&rt_reclaim_mutex);
+
+    if(rt_reclaim_wq){
+        /*Makes sure all the works are queued, then drains them*/
+        rcu_barrier();
+        destroy_workqueue(rt_reclaim_wq);
+        rt_reclaim_wq = NULL;
+    }
+
+    mutex_unlock(&rt_reclaim_mutex);
+#else
+    pthread_mutex_lock(&rt_reclaim_mutex);
+    while(rt_reclaim_pending)
+        pthread_cond_wait(&rt_reclaim_cond, &rt_reclaim_mutex);
+    pthread_mutex_unlock(&rt_reclaim_mutex);
+#endif
+}
+
+/* Swaps the routes of the table for none, the engines being replaced by
+ * empty ones if keep_engines. Only the next hops, which are few, are
+ * not detached : lookups in flight resolve them through the table*/
+static void
+__rt_clear_rt_table(rt_table_t *rt_table, rt_bool_t keep_engines){
+
+    glthread_t *curr;
+    rt_table_dead_t *dead = RT_CALLOC(sizeof(rt_table_dead_t));
+    rt_dir24_8_t *dir = NULL;
+    rt_tbm_t *tbm4 = NULL;
+
+    if(!dead){
+        /*The slow way*/
+        ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+            rt_entry_delete(rt_table, rt_entry_glue_to_rt_entry(curr));
+        } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+        if(!keep_engines && rt_table->engine->detach)
+            rt_table->engine->detach(rt_table);
+        return;
+    }
+
+    if(keep_engines && rt_table->dir24_8 &&
+        !(dir = rt_dir24_8_create(rt_table->dir24_8->n_tbl8_groups)))
+        rt_log("%s(): DIR-24-8 table alloc failed, falling back to trie lookups\n",
+            __FUNCTION__);
+
+    if(keep_engines && rt_table->tbm4){
+        tbm4 = RT_CALLOC(sizeof(rt_tbm_t));
+        if(tbm4)
+            rt_tbm_init(tbm4, RT_IPV4_MAX_MASK);
+        else
+            rt_log("%s(): Tree bitmap alloc failed, falling back to trie lookups\n",
+                __FUNCTION__);
+    }
+
+    dead->head = rt_table->head;
+    if(dead->head.right)
+        dead->head.right->left = &dead->head;
+    dead->entry_pool = rt_table->entry_pool;
+    dead->cold = rt_table->cold;
+    dead->prefix_index = rt_table->prefix_index;
+    dead->trie = rt_table->trie;
+    dead->tbm6 = rt_table->tbm6;
+    dead->small4 = rt_table->small4;
+    dead->dir24_8 = rt_table->dir24_8;
+    dead->tbm4 = rt_table->tbm4;
+    dead->interval4 = rt_table->interval4;
+#ifndef __KERNEL__
+    /*Along with what is retired, the entries going to the detached pool*/
+    rt_table_dead_take_limbo(rt_table, dead);
+#endif
+
+    /*New lookups find nothing, those in flight finish on the old structures*/
+    RT_PUBLISH(rt_table->trie.root, NULL);
+    RT_PUBLISH(rt_table->tbm6.root, NULL);
+    RT_PUBLISH(rt_table->small4, NULL);
+    RT_PUBLISH(rt_table->dir24_8, dir);
+    RT_PUBLISH(rt_table->tbm4, tbm4);
+    /*Built again by rt_table_changed()*/
+    RT_PUBLISH(rt_table->interval4, NULL);
+
+    /*Engine which could not be emptied, the trie takes over*/
+    if(keep_engines && ((dead->dir24_8 && !dir) || (dead->tbm4 && !tbm4)))
+        RT_PUBLISH(rt_table->engine, rt_engines[RT_ENGINE_TRIE]);
+
+    init_glthread(&rt_table->head);
+    rt_pool_init(&rt_table->entry_pool, "rt_entry", sizeof(rt_entry_t));
+    rt_cold_table_init(&rt_table->cold);
+    memset(&rt_table->prefix_index, 0, sizeof(rt_table->prefix_index));
+    rt_trie_init(&rt_table->trie);
+    rt_tbm_init(&rt_table->tbm6, RT_IPV6_MAX_MASK);
+    rt_nexthop_table_flush(&rt_table->nexthops);
+
+    rt_table_dead_free(dead);
+}
+
+void
+rt_clear_rt_table(rt_table_t *rt_table){
+
+    rt_table_lock(rt_table);
+    __rt_clear_rt_table(rt_table, RT_TRUE);
+    rt_table_journal(rt_table, RT_JOURNAL_CLEAR, NULL);
+    rt_table_changed(rt_table);
+    rt_table_unlock(rt_table);
+}
+
+void
+rt_free_rt_table(rt_table_t *rt_table){
+
+    rt_table_disable_fib(rt_table);
+
+    rt_table_lock(rt_table);
+    __rt_clear_rt_table(rt_table, RT_FALSE);
+    rt_table_unlock(rt_table);
+
+    /*Lookups in flight may still resolve their next hop*/
+    RT_SYNCHRONIZE();
+    rt_nexthop_table_destroy(&rt_table->nexthops);
+    rt_journal_destroy(rt_table->journal);
+    rt_table->journal = NULL;
+    rt_counters_destroy(rt_table->counters);
+    rt_table->counters = NULL;
+    rt_pool_destroy(&rt_table->entry_pool);
+#ifdef __KERNEL__
+    mutex_destroy(&rt_table->lock);
+#else
+    rt_epoch_limbo_destroy(&rt_table->limbo);
+    pthread_cond_destroy(&rt_table->fib_cond);
+    pthread_mutex_destroy(&rt_table->lock);
+#endif
+}
+
+rt_bool_t
+rt_table_enable_journal(rt_table_t *rt_table, uint32_t n_changes){
+
+    rt_bool_t rc;
+
+    rt_table_lock(rt_table);
+    if(!rt_table->journal)
+        rt_table->journal = rt_journal_create(n_changes, rt_table->generation);
+    rc = rt_table->journal ? RT_TRUE : RT_FALSE;
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+void
+rt_table_disable_journal(rt_table_t *rt_table){
+
+    rt_table_lock(rt_table);
+    rt_journal_destroy(rt_table->journal);
+    rt_table->journal = NULL;
+    rt_table_unlock(rt_table);
+}
+
+rt_bool_t
+rt_table_changes_since(rt_table_t *rt_table, uint64_t generation,
+                       rt_change_fn_t fn, void *arg, uint64_t *to_generation){
+
+    rt_journal_t *journal;
+    uint64_t seq;
+    rt_bool_t rc = RT_FALSE;
+
+    rt_table_lock(rt_table);
+
+    journal = rt_table->journal;
+    *to_generation = rt_table->generation;
+
+    if(journal && rt_journal_find(journal, generation, &seq)){
+        for(; seq < journal->n_written; seq++)
+            fn(rt_journal_get(journal, seq), arg);
+        rc = RT_TRUE;
+    }
+
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+rt_bool_t
+rt_table_enable_counters(rt_table_t *rt_table){
+
+    glthread_t *curr;
+    rt_counters_t *counters;
+    rt_bool_t rc = RT_TRUE;
+
+    rt_table_lock(rt_table);
+
+    if(!rt_table->counters){
+
+        counters = rt_counters_create();
+
+        if(!counters){
+            rt_table_unlock(rt_table);
+            return RT_FALSE;
+        }
+
+        /*Makes room for the routes there are*/
+        ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+            if(!rt_counters_reset(counters, rt_entry_glue_to_rt_entry(curr)->cold_id))
+                rc = RT_FALSE;
+        } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+        if(rc)
+            RT_PUBLISH(rt_table->counters, counters);
+        else
+            rt_counters_destroy(counters);
+    }
+
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+void
+rt_table_disable_counters(rt_table_t *rt_table){
+
+    rt_counters_t *counters;
+
+    rt_table_lock(rt_table);
+    counters = rt_table->counters;
+    RT_PUBLISH(rt_table->counters, NULL);
+    rt_table_unlock(rt_table);
+
+    if(!counters)
+        return;
+
+    /*Lookups in flight may still be counting*/
+    RT_SYNCHRONIZE();
+    rt_counters_destroy(counters);
+}
+
+rt_bool_t
+rt_route_counters(rt_table_t *rt_table, char *dest_ip, char mask,
+                  rt_route_counter_t *counter){
+
+    uint8_t family;
+    uint8_t dest[RT_IPV6_ADDR_LEN];
+    rt_entry_t *rt_entry;
+    rt_bool_t rc = RT_FALSE;
+
+    if(!rt_prefix_parse(dest_ip, mask, &family, dest))
+        return RT_FALSE;
+
+    rt_table_lock(rt_table);
+
+    rt_entry = rt_prefix_index_lookup(rt_table, family, dest, mask);
+
+    if(rt_entry && rt_table->counters){
+        rt_counters_read(rt_table->counters, rt_entry->cold_id, counter);
+        rc = RT_TRUE;
+    }
+
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+/*Counters of rt_entry as dumped, "" if not enabled*/
+static void
+rt_entry_counters_text(rt_table_t *rt_table, rt_entry_t *rt_entry,
+                       char *buf, uint32_t buf_len){
+
+    rt_route_counter_t counter;
+
+    buf[0] = '\0';
+
+    if(!rt_table->counters)
+        return;
+
+    rt_counters_read(rt_table->counters, rt_entry->cold_id, &counter);
+    snprintf(buf, buf_len, "  hits %llu bytes %llu",
+        (unsigned long long)counter.hits, (unsigned long long)counter.bytes);
+}
+
+void
+rt_dump_rt_table(rt_table_t *rt_table){
+
+    glthread_t *curr;
+    rt_entry_t *rt_entry = NULL;
+    rt_entry_cold_t *cold;
+    rt_nexthop_t *nh;
+    rt_nexthop_group_t *group;
+    char gw_ip[RT_IP_ADDR_STRLEN];
+    char counters[64];
+    uint32_t i;
+
+    rt_table_lock(rt_table);
+
+    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+        rt_entry = rt_entry_glue_to_rt_entry(curr);
+        cold = rt_cold_get(&rt_table->cold, rt_entry->cold_id);
+        rt_entry_counters_text(rt_table, rt_entry, counters, sizeof(counters));
+
+        if(!(rt_entry->nh_id & RT_NEXTHOP_GROUP)){
+            nh = rt_nexthop_lookup(&rt_table->nexthops, rt_entry->nh_id);
+            rt_gw_ntop(nh, gw_ip, sizeof(gw_ip));
+            rt_log("%-20s %-4d %-20s %s%s\n",
+                cold->dest_ip,
+                rt_entry->mask,
+                gw_ip,
+                rt_nexthop_oif(&rt_table->nexthops, nh),
+                counters);
+            continue;
+        }
+
+        /*One line per path of a multipath route*/
+        group = rt_nexthop_group(&rt_table->nexthops, rt_entry->nh_id);
+
+        for(i = 0; i < group->n_paths; i++){
+            nh = rt_nexthop_lookup(&rt_table->nexthops, group->paths[i].nh_id);
+            rt_gw_ntop(nh, gw_ip, sizeof(gw_ip));
+            rt_log("%-20s %-4d %-20s %-16s weight %u%s\n",
+                i ? "" : cold->dest_ip,
+                rt_entry->mask,
+                gw_ip,
+                rt_nexthop_oif(&rt_table->nexthops, nh),
+                group->paths[i].weight,
+                i ? "" : counters);
+        }
+    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+    rt_table_unlock(rt_table);
+}
+
+/*Puts str as a string of format, CSV fields quoted only if need be*/
+static void
+rt_dump_put_str(rt_sink_t *sink, rt_dump_format_t format, const char *str){
+
+    char esc[8];
+
+    if(format == RT_DUMP_CSV && !strpbrk(str, ",\"\r\n")){
+        rt_sink_put(sink, str, strlen(str));
+        return;
+    }
+
+    rt_sink_put(sink, "\"", 1);
+
+    for(; *str; str++){
+
+        if(*str == '"')
+            rt_sink_put(sink, format == RT_DUMP_CSV ? "\"\"" : "\\\"", 2);
+        else if(format == RT_DUMP_JSON && (*str == '\\' || (uint8_t)*str < 0x20)){
+            snprintf(esc, sizeof(esc), "\\u%04x", (uint8_t)*str);
+            rt_sink_put(sink, esc, 6);
+        }
+        else
+            rt_sink_put(sink, str, 1);
+    }
+
+    rt_sink_put(sink, "\"", 1);
+}
+
+static void
+rt_dump_route(rt_table_t *rt_table, rt_entry_t *rt_entry,
+              rt_sink_t *sink, rt_dump_format_t format){
+
+    rt_nexthop_table_t *nh_table = &rt_table->nexthops;
+    rt_entry_cold_t *cold = rt_cold_get(&rt_table->cold, rt_entry->cold_id);
+    rt_nexthop_group_t *group = NULL;
+    rt_route_counter_t counter = {0};
+    rt_dump_rec_t rec;
+    rt_nexthop_t *nh;
+    char gw_ip[RT_IP_ADDR_STRLEN];
+    uint32_t n_paths = 1, weight = 1, i;
+
+    if(rt_table->counters)
+        rt_counters_read(rt_table->counters, rt_entry->cold_id, &counter);
+
+    if(rt_entry->nh_id & RT_NEXTHOP_GROUP){
+        group = rt_nexthop_group(nh_table, rt_entry->nh_id);
+        n_paths = group->n_paths;
+    }
+
+    if(format == RT_DUMP_JSON)
+        rt_sink_printf(sink, "{\"prefix\":\"%s\",\"mask\":%u,\"paths\":[",
+                       cold->dest_ip, rt_entry->mask);
+
+    for(i = 0; i < n_paths; i++){
+
+        if(group){
+            nh = rt_nexthop_lookup(nh_table, group->paths[i].nh_id);
+            weight = group->paths[i].weight;
+        }
+        else
+            nh = rt_nexthop_lookup(nh_table, rt_entry->nh_id);
+
+        switch(format){
+
+            case RT_DUMP_BINARY:
+                memset(&rec, 0, sizeof(rec));
+                memcpy(rec.dest_addr, rt_entry->dest_addr, sizeof(rec.dest_addr));
+                memcpy(rec.gw_addr, nh->gw_addr, sizeof(rec.gw_addr));
+                snprintf(rec.oif, sizeof(rec.oif), "%s", rt_nexthop_oif(nh_table, nh));
+                if(!i){
+                    rec.hits = counter.hits;
+                    rec.bytes = counter.bytes;
+                }
+                rec.ifindex = nh->ifindex;
+                rec.weight = weight;
+                rec.mask = rt_entry->mask;
+                rec.family = rt_entry->family;
+                rec.gw_family = nh->family;
+                rec.path = i;
+                rec.n_paths = n_paths;
+                rt_sink_put(sink, &rec, sizeof(rec));
+                break;
+
+            case RT_DUMP_CSV:
+                rt_gw_ntop(nh, gw_ip, sizeof(gw_ip));
+                rt_sink_printf(sink, "%s,%u,%s,", cold->dest_ip, rt_entry->mask, gw_ip);
+                rt_dump_put_str(sink, format, rt_nexthop_oif(nh_table, nh));
+                rt_sink_printf(sink, ",%u,%u", nh->ifindex, weight);
+                /*Left empty if not enabled, and on the other paths*/
+                if(rt_table->counters && !i)
+                    rt_sink_printf(sink, ",%llu,%llu\n",
+                        (unsigned long long)counter.hits,
+                        (unsigned long long)counter.bytes);
+                else
+                    rt_sink_put(sink, ",,\n", 3);
+                break;
+
+            case RT_DUMP_JSON:
+                rt_gw_ntop(nh, gw_ip, sizeof(gw_ip));
+                if(gw_ip[0])
+                    rt_sink_printf(sink, "%s{\"gw\":\"%s\",\"oif\":", i ? "," : "", gw_ip);
+                else
+                    rt_sink_printf(sink, "%s{\"gw\":null,\"oif\":", i ? "," : "");
+                rt_dump_put_str(sink, format, rt_nexthop_oif(nh_table, nh));
+                rt_sink_printf(sink, ",\"ifindex\":%u,\"weight\":%u}", nh->ifindex, weight);
+                break;
+        }
+    }
+
+    if(format != RT_DUMP_JSON)
+        return;
+
+    if(rt_table->counters)
+        rt_sink_printf(sink, "],\"hits\":%llu,\"bytes\":%llu}",
+            (unsigned long long)counter.hits, (unsigned long long)counter.bytes);
+    else
+        rt_sink_put(sink, "]}", 2);
+}
+
+rt_bool_t
+rt_dump_rt_table_to_sink(rt_table_t *rt_table, rt_sink_t *sink,
+                         rt_dump_format_t format){
+
+    glthread_t *curr;
+    rt_dump_header_t header;
+    rt_bool_t first = RT_TRUE;
+
+    rt_table_lock(rt_table);
+
+    switch(format){
+
+        case RT_DUMP_BINARY:
+            memset(&header, 0, sizeof(header));
+            header.magic = RT_DUMP_MAGIC;
+            header.version = RT_DUMP_VERSION;
+            header.rec_size = sizeof(rt_dump_rec_t);
+            header.generation = rt_table->generation;
+            rt_sink_put(sink, &header, sizeof(header));
+            break;
+
+        case RT_DUMP_CSV:
+            rt_sink_printf(sink, "prefix,mask,gw,oif,ifindex,weight,hits,bytes\n");
+            break;
+
+        case RT_DUMP_JSON:
+            rt_sink_put(sink, "[", 1);
+            break;
+    }
+
+    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+        if(sink->failed)
+            break;
+
+        if(format == RT_DUMP_JSON)
+            rt_sink_put(sink, first ? "\n" : ",\n", first ? 1 : 2);
+
+        rt_dump_route(rt_table, rt_entry_glue_to_rt_entry(curr), sink, format);
+        first = RT_FALSE;
+    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+    if(format == RT_DUMP_JSON)
+        rt_sink_put(sink, "\n]\n", 3);
+
+    rt_table_unlock(rt_table);
+
+    return rt_sink_flush(sink);
+}
+
+uint64_t
+rt_table_mem_usage(rt_table_t *rt_table){
+
+    rt_nexthop_table_t *nh_table = &rt_table->nexthops;
+
+    return rt_table->entry_pool.mem_bytes +
+           ((uint64_t)rt_table->cold.n_chunks * RT_COLD_CHUNK_SIZE *
+                sizeof(rt_entry_cold_t)) +
+           ((uint64_t)nh_table->capacity * sizeof(rt_nexthop_t)) +
+           ((uint64_t)nh_table->n_buckets * sizeof(uint32_t)) +
+           ((uint64_t)nh_table->group_next_id * sizeof(rt_nexthop_group_t)) +
+           ((uint64_t)nh_table->group_capacity *
+                (sizeof(rt_nexthop_group_t *) + sizeof(uint32_t))) +
+           ((uint64_t)nh_table->ifaces.capacity *
+                (sizeof(rt_iface_t) + sizeof(uint32_t)));
+}
+
+rt_entry_t *
+rt_lookup_lpm(rt_table_t *rt_table, uint32_t addr){
+
+    return RT_DEREF(rt_table->engine)->lookup(rt_table, addr);
+}
+
+rt_entry_t *
+rt_lookup_lpm6(rt_table_t *rt_table, const uint8_t *addr){
+
+    return rt_tbm_lookup(&rt_table->tbm6, addr);
+}
+
+/*The caller reads the routes found next*/
+static void
+rt_prefetch_results(rt_entry_t **results, uint32_t n){
+
+    uint32_t i;
+
+    for(i = 0; i < n; i++){
+        if(results[i])
+            RT_PREFETCH(results[i]);
+    }
+}
+
+void
+rt_lookup_batch(rt_table_t *rt_table, const uint32_t *addrs,
+                rt_entry_t **results, uint32_t n){
+
+    RT_DEREF(rt_table->engine)->lookup_batch(rt_table, addrs, results, n);
+    rt_prefetch_results(results, n);
+}
+
+void
+rt_lookup_batch6(rt_table_t *rt_table, const uint8_t *addrs,
+                 rt_entry_t **results, uint32_t n){
+
+    rt_tbm_lookup_batch(&rt_table->tbm6, addrs, (void **)results, n);
+    rt_prefetch_results(results, n);
+}
+
+/* IPV4 lookup engines. The structures of an engine are in the table,
+ * NULL while it is not the engine of the table, and its lookups fall
+ * back to the trie without them*/
+
+/*List : scanned while the routes are few, see rt_table_small_sync()*/
+static rt_bool_t
+rt_engine_list_attach(rt_table_t *rt_table, uint32_t param){
+
+    (void)param;
+    /*Out of memory only costs trie lookups*/
+    rt_table_small_sync(rt_table);
+    return RT_TRUE;
+}
+
+static void
+rt_engine_list_detach(rt_table_t *rt_table){
+
+    rt_table_small_replace(rt_table, NULL);
+}
+
+static void
+rt_engine_list_add(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    if(rt_table->small4)
+        rt_table_small_replace(rt_table, rt_small_insert(rt_table->small4,
+            rt_prefix_ipv4(rt_entry->dest_addr), rt_entry->mask, rt_entry));
+}
+
+static void
+rt_engine_list_remove(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    if(rt_table->small4)
+        rt_table_small_replace(rt_table, rt_small_delete(rt_table->small4,
+            rt_prefix_ipv4(rt_entry->dest_addr), rt_entry->mask));
+}
+
+static rt_entry_t *
+rt_engine_list_lookup(rt_table_t *rt_table, uint32_t addr){
+
+    rt_small_t *small = RT_DEREF(rt_table->small4);
+
+    if(small)
+        return rt_small_lookup(small, addr);
+
+    return rt_trie_lookup(&rt_table->trie, addr);
+}
+
+static void
+rt_engine_list_lookup_batch(rt_table_t *rt_table, const uint32_t *addrs,
+                            rt_entry_t **results, uint32_t n){
+
+    rt_small_t *small = RT_DEREF(rt_table->small4);
+    uint32_t i;
+
+    if(!small){
+        rt_trie_lookup_batch(&rt_table->trie, addrs, (void **)results, n);
+        return;
+    }
+
+    /*Fits in a few cache lines, nothing to overlap*/
+    for(i = 0; i < n; i++)
+        results[i] = rt_small_lookup(small, addrs[i]);
+}
+
+/*Trie : the index of the routes itself, nothing to maintain*/
+static rt_entry_t *
+rt_engine_trie_lookup(rt_table_t *rt_table, uint32_t addr){
+
+    return rt_trie_lookup(&rt_table->trie, addr);
+}
+
+static void
+rt_engine_trie_lookup_batch(rt_table_t *rt_table, const uint32_t *addrs,
+                            rt_entry_t **results, uint32_t n){
+
+    rt_trie_lookup_batch(&rt_table->trie, addrs, (void **)results, n);
+}
+
+/*Tree bitmap*/
+static rt_bool_t
+rt_engine_tbm_attach(rt_table_t *rt_table, uint32_t param){
+
+    glthread_t *curr;
+    rt_entry_t *rt_entry = NULL;
+    rt_tbm_t *tbm;
+
+    (void)param;
+
+    tbm = RT_CALLOC(sizeof(rt_tbm_t));
+
+    if(!tbm)
+        return RT_FALSE;
+
+    rt_tbm_init(tbm, RT_IPV4_MAX_MASK);
+
+    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+        rt_entry = rt_entry_glue_to_rt_entry(curr);
+
+        if(rt_entry->family != AF_INET)
+            continue;
+
+        if(!rt_tbm_insert(tbm, rt_entry->dest_addr, rt_entry->mask, rt_entry)){
+            rt_tbm_destroy(tbm);
+            RT_FREE(tbm);
+            return RT_FALSE;
+        }
+    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+    RT_PUBLISH(rt_table->tbm4, tbm);
+    return RT_TRUE;
+}
+
+static void
+rt_engine_tbm_detach(rt_table_t *rt_table){
+
+    rt_tbm_t *tbm = rt_table->tbm4;
+
+    if(!tbm)
+        return;
+
+    RT_PUBLISH(rt_table->tbm4, NULL);
+    RT_SYNCHRONIZE();
+    rt_tbm_destroy(tbm);
+    RT_FREE(tbm);
+}
+
+static void
+rt_engine_tbm_add(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    if(rt_table->tbm4 &&
+        !rt_tbm_insert(rt_table->tbm4, rt_entry->dest_addr, rt_entry->mask, rt_entry)){
+        rt_log("%s(): Tree bitmap insert failed, falling back to trie lookups\n",
+            __FUNCTION__);
+        __rt_table_set_engine(rt_table, RT_ENGINE_TRIE, 0);
+    }
+}
+
+static void
+rt_engine_tbm_remove(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    /*Out of memory to copy the tree bitmap nodes*/
+    if(rt_table->tbm4 &&
+        !rt_tbm_delete(rt_table->tbm4, rt_entry->dest_addr, rt_entry->mask)){
+        rt_log("%s(): Tree bitmap delete failed, falling back to trie lookups\n",
+            __FUNCTION__);
+        __rt_table_set_engine(rt_table, RT_ENGINE_TRIE, 0);
+    }
+}
+
+static rt_entry_t *
+rt_engine_tbm_lookup(rt_table_t *rt_table, uint32_t addr){
+
+    uint32_t addr_n = htonl(addr);
+    rt_tbm_t *tbm = RT_DEREF(rt_table->tbm4);
+
+    if(tbm)
+        return rt_tbm_lookup(tbm, (uint8_t *)&addr_n);
+
+    return rt_trie_lookup(&rt_table->trie, addr);
+}
+
+static void
+rt_engine_tbm_lookup_batch(rt_table_t *rt_table, const uint32_t *addrs,
+                           rt_entry_t **results, uint32_t n){
+
+    uint32_t addrs_n[RT_LOOKUP_GROUP];
+    uint32_t base, n_group, i;
+    rt_tbm_t *tbm = RT_DEREF(rt_table->tbm4);
+
+    if(!tbm){
+        rt_trie_lookup_batch(&rt_table->trie, addrs, (void **)results, n);
+        return;
+    }
+
+    /*The tree bitmap takes the addrs in network byte order*/
+    for(base = 0; base < n; base += RT_LOOKUP_GROUP){
+
+        n_group = n - base < RT_LOOKUP_GROUP ? n - base : RT_LOOKUP_GROUP;
+
+        for(i = 0; i < n_group; i++)
+            addrs_n[i] = htonl(addrs[base + i]);
+
+        rt_tbm_lookup_batch(tbm, (uint8_t *)addrs_n,
+            (void **)&results[base], n_group);
+    }
+}
+
+/*DIR-24-8, param bounds its tbl8 groups*/
+static rt_bool_t
+rt_engine_dir24_8_attach(rt_table_t *rt_table, uint32_t param){
+
+    glthread_t *curr;
+    rt_entry_t *rt_entry = NULL;
+    rt_dir24_8_t *dir;
+
+    dir = rt_dir24_8_create(param);
+
+    if(!dir)
+        return RT_FALSE;
+
+    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+        rt_entry = rt_entry_glue_to_rt_entry(curr);
+
+        if(rt_entry->family != AF_INET)
+            continue;
+
+        if(!rt_dir24_8_add(dir, rt_prefix_ipv4(rt_entry->dest_addr),
+                rt_entry->mask, rt_entry,
+                &rt_entry->dir24_8_nh_idx)){
+            rt_dir24_8_destroy(dir);
+            return RT_FALSE;
+        }
+    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+    RT_PUBLISH(rt_table->dir24_8, dir);
+    return RT_TRUE;
+}
+
+static void
+rt_engine_dir24_8_detach(rt_table_t *rt_table){
+
+    rt_dir24_8_t *dir = rt_table->dir24_8;
+
+    if(!dir)
+        return;
+
+    RT_PUBLISH(rt_table->dir24_8, NULL);
+    RT_SYNCHRONIZE();
+    rt_dir24_8_destroy(dir);
+}
+
+static void
+rt_engine_dir24_8_add(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    if(rt_table->dir24_8 &&
+        !rt_dir24_8_add(rt_table->dir24_8, rt_prefix_ipv4(rt_entry->dest_addr),
+            rt_entry->mask, rt_entry, &rt_entry->dir24_8_nh_idx)){
+        rt_log("%s(): DIR-24-8 table exhausted, falling back to trie lookups\n",
+            __FUNCTION__);
+        __rt_table_set_engine(rt_table, RT_ENGINE_TRIE, 0);
+    }
+}
+
+static void
+rt_engine_dir24_8_remove(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    uint32_t dest = rt_prefix_ipv4(rt_entry->dest_addr);
+    uint8_t rep_mask = 0;
+    rt_entry_t *rep_entry = NULL;
+
+    if(!rt_table->dir24_8)
+        return;
+
+    rep_entry = rt_trie_get_parent(&rt_table->trie, dest, rt_entry->mask, &rep_mask);
+    rt_dir24_8_delete(rt_table->dir24_8, dest, rt_entry->mask,
+        rt_entry->dir24_8_nh_idx,
+        rep_entry ? rep_entry->dir24_8_nh_idx : RT_DIR24_8_INVALID_IDX,
+        rep_mask);
+}
+
+static rt_entry_t *
+rt_engine_dir24_8_lookup(rt_table_t *rt_table, uint32_t addr){
+
+    rt_dir24_8_t *dir = RT_DEREF(rt_table->dir24_8);
+
+    if(dir)
+        return rt_dir24_8_lookup(dir, addr);
+
+    return rt_trie_lookup(&rt_table->trie, addr);
+}
+
+static void
+rt_engine_dir24_8_lookup_batch(rt_table_t *rt_table, const uint32_t *addrs,
+                               rt_entry_t **results, uint32_t n){
+
+    rt_dir24_8_t *dir = RT_DEREF(rt_table->dir24_8);
+
+    if(dir)
+        rt_dir24_8_lookup_batch(dir, addrs, (void **)results, n);
+    else
+        rt_trie_lookup_batch(&rt_table->trie, addrs, (void **)results, n);
+}
+
+/*Interval array, built again at the end of each call changing the routes*/
+static void
+rt_table_interval_replace(rt_table_t *rt_table, rt_interval_t *interval){
+
+    rt_interval_t *old = rt_table->interval4;
+
+    RT_PUBLISH(rt_table->interval4, interval);
+    if(old)
+        RT_FREE_DEFERRED(old);
+}
+
+static rt_interval_t *
+rt_table_interval_build(rt_table_t *rt_table){
+
+    glthread_t *curr;
+    rt_entry_t *rt_entry = NULL;
+    uint32_t n = 0, n_max = rt_table->trie.n_prefixes, *keys;
+    uint8_t *plens;
+    void **data;
+    rt_interval_t *interval;
+
+    data = RT_CALLOC_LARGE(((uint64_t)n_max + 1) *
+                (sizeof(void *) + sizeof(uint32_t) + sizeof(uint8_t)));
+
+    if(!data)
+        return NULL;
+
+    keys = (uint32_t *)(data + (n_max + 1));
+    plens = (uint8_t *)(keys + (n_max + 1));
+
+    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+
+        rt_entry = rt_entry_glue_to_rt_entry(curr);
+
+        if(rt_entry->family != AF_INET)
+            continue;
+
+        keys[n] = rt_prefix_ipv4(rt_entry->dest_addr);
+        plens[n] = rt_entry->mask;
+        data[n++] = rt_entry;
+    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+
+    interval = rt_interval_build(keys, plens, data, n);
+    RT_FREE_LARGE(data);
+    return interval;
+}
+
+static rt_bool_t
+rt_engine_interval_attach(rt_table_t *rt_table, uint32_t param){
+
+    rt_interval_t *interval;
+
+    (void)param;
+
+    if(!(interval = rt_table_interval_build(rt_table)))
+        return RT_FALSE;
+
+    RT_PUBLISH(rt_table->interval4, interval);
+    return RT_TRUE;
+}
+
+static void
+rt_engine_interval_detach(rt_table_t *rt_table){
+
+    rt_table_interval_replace(rt_table, NULL);
+}
+
+/*The trie answers until the end of the call*/
+static void
+rt_engine_interval_drop(rt_table_t *rt_table, rt_entry_t *rt_entry){
+
+    (void)rt_entry;
+    if(rt_table->interval4)
+        rt_table_interval_replace(rt_table, NULL);
+}
+
+static void
+rt_engine_interval_changed(rt_table_t *rt_table){
+
+    /*Out of memory, the trie answers until the next change*/
+    if(!rt_table->interval4)
+        rt_table_interval_replace(rt_table, rt_table_interval_build(rt_table));
+}
+
+static rt_entry_t *
+rt_engine_interval_lookup(rt_table_t *rt_table, uint32_t addr){
+
+    rt_interval_t *interval = RT_DEREF(rt_table->interval4);
+
+    if(interval)
+        return rt_interval_lookup(interval, addr);
+
+    return rt_trie_lookup(&rt_table->trie, addr);
+}
+
+static void
+rt_engine_interval_lookup_batch(rt_table_t *rt_table, const uint32_t *addrs,
+                                rt_entry_t **results, uint32_t n){
+
+    rt_interval_t *interval = RT_DEREF(rt_table->interval4);
+
+    if(interval)
+        rt_interval_lookup_batch(interval, addrs, (void **)results, n);
+    else
+        rt_trie_lookup_batch(&rt_table->trie, addrs, (void **)results, n);
+}
+
+static const rt_engine_ops_t rt_engine_list = {
+
+    .type = RT_ENGINE_LIST,
+    .name = "list",
+    .attach = rt_engine_list_attach,
+    .detach = rt_engine_list_detach,
+    .add = rt_engine_list_add,
+    .remove = rt_engine_list_remove,
+    .changed = rt_table_small_sync,
+    .lookup = rt_engine_list_lookup,
+    .lookup_batch = rt_engine_list_lookup_batch,
+};
+
+static const rt_engine_ops_t rt_engine_trie = {
+
+    .type = RT_ENGINE_TRIE,
+    .name = "trie",
+    .lookup = rt_engine_trie_lookup,
+    .lookup_batch = rt_engine_trie_lookup_batch,
+};
+
+static const rt_engine_ops_t rt_engine_tbm = {
+
+    .type = RT_ENGINE_TBM,
+    .name = "tbm",
+    .attach = rt_engine_tbm_attach,
+    .detach = rt_engine_tbm_detach,
+    .add = rt_engine_tbm_add,
+    .remove = rt_engine_tbm_remove,
+    .lookup = rt_engine_tbm_lookup,
+    .lookup_batch = rt_engine_tbm_lookup_batch,
+};
+
+static const rt_engine_ops_t rt_engine_dir24_8 = {
+
+    .type = RT_ENGINE_DIR24_8,
+    .name = "dir24_8",
+    .attach = rt_engine_dir24_8_attach,
+    .detach = rt_engine_dir24_8_detach,
+    .add = rt_engine_dir24_8_add,
+    .remove = rt_engine_dir24_8_remove,
+    .lookup = rt_engine_dir24_8_lookup,
+    .lookup_batch = rt_engine_dir24_8_lookup_batch,
+};
+
+static const rt_engine_ops_t rt_engine_interval = {
+
+    .type = RT_ENGINE_INTERVAL,
+    .name = "interval",
+    .attach = rt_engine_interval_attach,
+    .detach = rt_engine_interval_detach,
+    .add = rt_engine_interval_drop,
+    .remove = rt_engine_interval_drop,
+    .changed = rt_engine_interval_changed,
+    .lookup = rt_engine_interval_lookup,
+    .lookup_batch = rt_engine_interval_lookup_batch,
+};
+
+static const rt_engine_ops_t *const rt_engines[RT_ENGINE_MAX] = {
+
+    [RT_ENGINE_LIST] = &rt_engine_list,
+    [RT_ENGINE_TRIE] = &rt_engine_trie,
+    [RT_ENGINE_TBM] = &rt_engine_tbm,
+    [RT_ENGINE_DIR24_8] = &rt_engine_dir24_8,
+    [RT_ENGINE_INTERVAL] = &rt_engine_interval,
+};
+
+static rt_bool_t
+__rt_table_set_engine(rt_table_t *rt_table, rt_engine_t engine, uint32_t param){
+
+    const rt_engine_ops_t *old = rt_table->engine;
+    const rt_engine_ops_t *new;
+
+    if((uint32_t)engine >= RT_ENGINE_MAX)
+        return RT_FALSE;
+
+    new = rt_engines[engine];
+
+    if(new == old)
+        return RT_TRUE;
+
+    /*Built while the lookups go on with the current engine*/
+    if(new->attach && !new->attach(rt_table, param))
+        return RT_FALSE;
+
+    RT_PUBLISH(rt_table->engine, new);
+
+    /*Frees the old structures once the lookups in flight are done*/
+    if(old->detach)
+        old->detach(rt_table);
+    return RT_TRUE;
+}
+
+rt_bool_t
+rt_table_set_engine(rt_table_t *rt_table, rt_engine_t engine, uint32_t param){
+
+    rt_bool_t rc;
+
+    rt_table_lock(rt_table);
+    rc = __rt_table_set_engine(rt_table, engine, param);
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+const char *
+rt_engine_name(rt_engine_t engine){
+
+    if((uint32_t)engine >= RT_ENGINE_MAX)
+        return "unknown";
+
+    return rt_engines[engine]->name;
+}
+
+rt_bool_t
+rt_table_enable_dir24_8(rt_table_t *rt_table, uint32_t tbl8_groups){
+
+    return rt_table_set_engine(rt_table, RT_ENGINE_DIR24_8, tbl8_groups);
+}
+
+/*Back to the default engine if the table uses this one*/
+static void
+rt_table_disable_engine(rt_table_t *rt_table, rt_engine_t engine){
+
+    rt_table_lock(rt_table);
+    if(rt_table->engine->type == engine)
+        __rt_table_set_engine(rt_table, RT_ENGINE_LIST, 0);
+    rt_table_unlock(rt_table);
+}
+
+void
+rt_table_disable_dir24_8(rt_table_t *rt_table){
+
+    rt_table_disable_engine(rt_table, RT_ENGINE_DIR24_8);
+}
+
+rt_bool_t
+rt_table_enable_tbm4(rt_table_t *rt_table){
+
+    return rt_table_set_engine(rt_table, RT_ENGINE_TBM, 0);
+}
+
+void
+rt_table_disable_tbm4(rt_table_t *rt_table){
+
+    rt_table_disable_engine(rt_table, RT_ENGINE_TBM);
+}
+
+rt_bool_t
+rt_table_enable_fib(rt_table_t *rt_table, uint32_t debounce_ms){
+
+    rt_bool_t rc;
+
+    rt_table_lock(rt_table);
+
+    rc = __rt_table_fib_compile(rt_table);
+    if(rc)
+        rt_table->fib_debounce_ms = debounce_ms;
+#ifndef __KERNEL__
+    if(rc && debounce_ms && !rt_table->fib_thread_running){
+        if(pthread_create(&rt_table->fib_thread, NULL, rt_fib_thread_fn, rt_table) == 0)
+            rt_table->fib_thread_running = RT_TRUE;
+        else
+            rt_table->fib_debounce_ms = 0;
+    }
+#endif
+
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+void
+rt_table_disable_fib(rt_table_t *rt_table){
+
+    rt_fib_t *fib;
+
+    /*Stop the recompilations first, they take the table lock*/
+    rt_table_lock(rt_table);
+    rt_table->fib_debounce_ms = 0;
+#ifndef __KERNEL__
+    pthread_cond_signal(&rt_table->fib_cond);
+#endif
+    rt_table_unlock(rt_table);
+#ifdef __KERNEL__
+    cancel_delayed_work_sync(&rt_table->fib_work);
+#else
+    if(rt_table->fib_thread_running){
+        pthread_join(rt_table->fib_thread, NULL);
+        rt_table->fib_thread_running = RT_FALSE;
+    }
+#endif
+
+    rt_table_lock(rt_table);
+    fib = rt_table->fib;
+    RT_PUBLISH(rt_table->fib, NULL);
+    RT_FREE_DEFERRED(fib);
+    rt_table_unlock(rt_table);
+}
+
+rt_bool_t
+rt_table_compress_fib(rt_table_t *rt_table, rt_bool_t compress){
+
+    rt_bool_t rc = RT_TRUE;
+
+    rt_table_lock(rt_table);
+    rt_table->fib_compress = compress;
+    if(rt_table->fib)
+        rc = __rt_table_fib_compile(rt_table);
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+rt_bool_t
+rt_table_fib_compile(rt_table_t *rt_table){
+
+    rt_bool_t rc = RT_FALSE;
+
+    rt_table_lock(rt_table);
+    if(rt_table->fib)
+        rc = __rt_table_fib_compile(rt_table);
+    rt_table_unlock(rt_table);
+    return rc;
+}
+
+#ifndef __KERNEL__
+rt_bool_t
+rt_table_save(rt_table_t *rt_table, const char *path){
+
+    rt_fib_t *fib;
+    rt_bool_t rc;
+
+    rt_table_lock(rt_table);
+    fib = __rt_table_fib_build(rt_table);
+    rt_table_unlock(rt_table);
+
+    if(!fib)
+        return RT_FALSE;
+
+    rc = rt_fib_save(fib, path);
+    rt_fib_free(fib);
+    return rc;
+}
+#endif
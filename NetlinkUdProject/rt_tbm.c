@@ -0,0 +1,503 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_tbm.c
+ *
+ *    Description:  Implementation of tree bitmap multibit trie for IPV4 and IPV6 longest prefix match
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 12:14:51 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_tbm.h"
+
+#define RT_TBM_MAX_DEPTH    ((RT_IPV6_MAX_MASK / RT_TBM_STRIDE) + 1)
+
+/*Bit i of the bitmaps*/
+#define RT_TBM_BIT(i)       (1ULL << (i))
+/*Number of bits set in bmp below bit i, i.e. the array index of bit i*/
+#define RT_TBM_INDEX(bmp, i)    RT_POPCOUNT64((bmp) & (RT_TBM_BIT(i) - 1))
+
+/*The 6 bits of key starting at bit pos, bits beyond the key read as 0*/
+static inline uint32_t
+rt_tbm_chunk(const uint8_t *key, uint8_t key_bits, uint32_t pos){
+
+    uint32_t byte = pos >> 3;
+    uint32_t w = (uint32_t)key[byte] << 8;
+
+    if(byte + 1 < (uint32_t)(key_bits >> 3))
+        w |= key[byte + 1];
+
+    return (w >> (16 - (pos & 7) - RT_TBM_STRIDE)) & (RT_TBM_BIT(RT_TBM_STRIDE) - 1);
+}
+
+/*Position in int_bmp of the prefix having r bits of value v left in the node*/
+static inline uint32_t
+rt_tbm_int_pos(uint32_t r, uint32_t v){
+
+    return (1U << r) - 1 + v;
+}
+
+/*All the int_bmp positions which match the 6 bit chunk v*/
+static inline uint64_t
+rt_tbm_int_match_mask(uint32_t v){
+
+    uint64_t mask = 0;
+    uint32_t r;
+
+    for(r = 0; r < RT_TBM_STRIDE; r++)
+        mask |= RT_TBM_BIT(rt_tbm_int_pos(r, v >> (RT_TBM_STRIDE - r)));
+    return mask;
+}
+
+/* Arrays are always sized to the exact number of elements. A slot is
+ * opened/closed by copying into a new array, arr itself is left as is
+ * since lookups may be reading it. Return NULL on allocation failure*/
+static void *
+rt_tbm_array_insert(const void *arr, uint32_t n, uint32_t idx, size_t elem_size){
+
+    char *new_arr = RT_CALLOC((n + 1) * elem_size);
+
+    if(!new_arr)
+        return NULL;
+
+    if(arr){
+        memcpy(new_arr, arr, idx * elem_size);
+        memcpy(new_arr + ((idx + 1) * elem_size), (const char *)arr + (idx * elem_size),
+            (n - idx) * elem_size);
+    }
+    return new_arr;
+}
+
+/*Removing the last element yields a NULL array, which is no failure*/
+static rt_bool_t
+rt_tbm_array_remove(const void *arr, uint32_t n, uint32_t idx, size_t elem_size,
+                    void **new_arr){
+
+    char *arr2;
+
+    *new_arr = NULL;
+
+    if(n == 1)
+        return RT_TRUE;
+
+    arr2 = RT_CALLOC((n - 1) * elem_size);
+
+    if(!arr2)
+        return RT_FALSE;
+
+    memcpy(arr2, arr, idx * elem_size);
+    memcpy(arr2 + (idx * elem_size), (const char *)arr + ((idx + 1) * elem_size),
+        (n - idx - 1) * elem_size);
+    *new_arr = arr2;
+    return RT_TRUE;
+}
+
+void
+rt_tbm_init(rt_tbm_t *tbm, uint8_t key_bits){
+
+    memset(tbm, 0, sizeof(rt_tbm_t));
+    tbm->key_bits = key_bits;
+}
+
+static void
+rt_tbm_node_free_subtree(rt_tbm_node_t *node){
+
+    uint32_t i, n = RT_POPCOUNT64(node->ext_bmp);
+
+    for(i = 0; i < n; i++)
+        rt_tbm_node_free_subtree(&node->children[i]);
+
+    RT_FREE(node->children);
+    RT_FREE(node->results);
+}
+
+void
+rt_tbm_destroy(rt_tbm_t *tbm){
+
+    if(tbm->root){
+        rt_tbm_node_free_subtree(tbm->root);
+        RT_FREE(tbm->root);
+    }
+    rt_tbm_init(tbm, tbm->key_bits);
+}
+
+/* A node which lookups can reach is never modified in place. Instead
+ * the modified copy of the node at path[depth] is placed in a copy of
+ * its parent's children array, and that array is published with a
+ * single pointer store, the parent's bitmaps being unchanged. The root
+ * is replaced as a whole. Returns RT_FALSE on allocation failure*/
+static rt_bool_t
+rt_tbm_publish(rt_tbm_t *tbm, rt_tbm_node_t **path, uint32_t *path_idx,
+               uint32_t depth, const rt_tbm_node_t *new_node){
+
+    rt_tbm_node_t *parent, *arr = NULL, *old;
+    uint32_t n;
+
+    if(!depth){
+
+        if(new_node->ext_bmp || new_node->int_bmp){
+            arr = RT_CALLOC(sizeof(rt_tbm_node_t));
+            if(!arr)
+                return RT_FALSE;
+            *arr = *new_node;
+        }
+
+        old = tbm->root;
+        RT_PUBLISH(tbm->root, arr);
+        RT_FREE_DEFERRED(old);
+        return RT_TRUE;
+    }
+
+    parent = path[depth - 1];
+    n = RT_POPCOUNT64(parent->ext_bmp);
+    arr = RT_CALLOC(n * sizeof(rt_tbm_node_t));
+
+    if(!arr)
+        return RT_FALSE;
+
+    memcpy(arr, parent->children, n * sizeof(rt_tbm_node_t));
+    arr[path_idx[depth - 1]] = *new_node;
+
+    old = parent->children;
+    RT_PUBLISH(parent->children, arr);
+    RT_FREE_DEFERRED(old);
+    return RT_TRUE;
+}
+
+rt_bool_t
+rt_tbm_insert(rt_tbm_t *tbm, const uint8_t *key, uint8_t plen, void *data){
+
+    rt_tbm_node_t *path[RT_TBM_MAX_DEPTH];
+    uint32_t path_idx[RT_TBM_MAX_DEPTH];
+    rt_tbm_node_t empty, new_node, sub, *arr;
+    rt_tbm_node_t *node;
+    void **results;
+    void *old;
+    uint32_t pos = 0, depth = 0, v, r, n_new = 0;
+
+    if(plen > tbm->key_bits || !data)
+        return RT_FALSE;
+
+    memset(&empty, 0, sizeof(empty));
+    node = tbm->root ? tbm->root : &empty;
+
+    while(plen - pos >= RT_TBM_STRIDE){
+
+        v = rt_tbm_chunk(key, tbm->key_bits, pos);
+
+        if(!(node->ext_bmp & RT_TBM_BIT(v)))
+            break;
+
+        path[depth] = node;
+        path_idx[depth++] = RT_TBM_INDEX(node->ext_bmp, v);
+        node = &node->children[path_idx[depth - 1]];
+        pos += RT_TBM_STRIDE;
+    }
+
+    new_node = *node;
+
+    if(plen - pos < RT_TBM_STRIDE){
+
+        /*The prefix ends in an existing node*/
+        r = plen - pos;
+        v = rt_tbm_int_pos(r, rt_tbm_chunk(key, tbm->key_bits, pos) >> (RT_TBM_STRIDE - r));
+
+        if(node->int_bmp & RT_TBM_BIT(v))
+            return RT_FALSE;
+
+        results = rt_tbm_array_insert(node->results, RT_POPCOUNT64(node->int_bmp),
+                    RT_TBM_INDEX(node->int_bmp, v), sizeof(void *));
+        if(!results)
+            return RT_FALSE;
+
+        results[RT_TBM_INDEX(node->int_bmp, v)] = data;
+        new_node.results = results;
+        new_node.int_bmp |= RT_TBM_BIT(v);
+        old = node->results;
+
+        if(!rt_tbm_publish(tbm, path, path_idx, depth, &new_node)){
+            RT_FREE(results);
+            return RT_FALSE;
+        }
+
+        RT_FREE_DEFERRED(old);
+        tbm->n_prefixes++;
+        return RT_TRUE;
+    }
+
+    /*Build the missing chain of nodes bottom up, out of sight of lookups*/
+    memset(&sub, 0, sizeof(sub));
+    r = (plen - pos) % RT_TBM_STRIDE;
+    v = pos + (((plen - pos) / RT_TBM_STRIDE) * RT_TBM_STRIDE);
+
+    sub.results = RT_CALLOC(sizeof(void *));
+    if(!sub.results)
+        return RT_FALSE;
+    sub.results[0] = data;
+    sub.int_bmp = RT_TBM_BIT(rt_tbm_int_pos(r,
+                    rt_tbm_chunk(key, tbm->key_bits, v) >> (RT_TBM_STRIDE - r)));
+
+    while((v -= RT_TBM_STRIDE) > pos){
+
+        arr = RT_CALLOC(sizeof(rt_tbm_node_t));
+        if(!arr){
+            rt_tbm_node_free_subtree(&sub);
+            return RT_FALSE;
+        }
+
+        *arr = sub;
+        memset(&sub, 0, sizeof(sub));
+        sub.children = arr;
+        sub.ext_bmp = RT_TBM_BIT(rt_tbm_chunk(key, tbm->key_bits, v));
+        n_new++;
+    }
+
+    /*Hook it under node*/
+    v = rt_tbm_chunk(key, tbm->key_bits, pos);
+    arr = rt_tbm_array_insert(node->children, RT_POPCOUNT64(node->ext_bmp),
+            RT_TBM_INDEX(node->ext_bmp, v), sizeof(rt_tbm_node_t));
+    if(!arr){
+        rt_tbm_node_free_subtree(&sub);
+        return RT_FALSE;
+    }
+
+    arr[RT_TBM_INDEX(node->ext_bmp, v)] = sub;
+    new_node.children = arr;
+    new_node.ext_bmp |= RT_TBM_BIT(v);
+    old = node->children;
+
+    if(!rt_tbm_publish(tbm, path, path_idx, depth, &new_node)){
+        rt_tbm_node_free_subtree(&sub);
+        RT_FREE(arr);
+        return RT_FALSE;
+    }
+
+    RT_FREE_DEFERRED(old);
+    tbm->n_nodes += n_new + 1;
+    tbm->n_prefixes++;
+    return RT_TRUE;
+}
+
+void *
+rt_tbm_delete(rt_tbm_t *tbm, const uint8_t *key, uint8_t plen){
+
+    rt_tbm_node_t *path[RT_TBM_MAX_DEPTH];
+    uint32_t path_idx[RT_TBM_MAX_DEPTH];
+    uint32_t path_v[RT_TBM_MAX_DEPTH];
+    /*Arrays replaced by the copies, freed once the copies are published*/
+    void *old[RT_TBM_MAX_DEPTH + 1];
+    void *new_arr;
+    rt_tbm_node_t new_node, *node = tbm->root;
+    uint32_t pos = 0, depth = 0, n_old = 0, n_pruned = 0, v, idx, r, i;
+    void *data;
+
+    if(plen > tbm->key_bits || !node)
+        return NULL;
+
+    while(plen - pos >= RT_TBM_STRIDE){
+
+        v = rt_tbm_chunk(key, tbm->key_bits, pos);
+
+        if(!(node->ext_bmp & RT_TBM_BIT(v)))
+            return NULL;
+
+        path[depth] = node;
+        path_v[depth] = v;
+        path_idx[depth++] = RT_TBM_INDEX(node->ext_bmp, v);
+        node = &node->children[path_idx[depth - 1]];
+        pos += RT_TBM_STRIDE;
+    }
+
+    r = plen - pos;
+    v = rt_tbm_int_pos(r, rt_tbm_chunk(key, tbm->key_bits, pos) >> (RT_TBM_STRIDE - r));
+
+    if(!(node->int_bmp & RT_TBM_BIT(v)))
+        return NULL;
+
+    idx = RT_TBM_INDEX(node->int_bmp, v);
+    data = node->results[idx];
+
+    new_node = *node;
+    if(!rt_tbm_array_remove(node->results, RT_POPCOUNT64(node->int_bmp), idx,
+            sizeof(void *), &new_arr))
+        return NULL;
+    new_node.results = new_arr;
+    new_node.int_bmp &= ~RT_TBM_BIT(v);
+    old[n_old++] = node->results;
+
+    /*Give back the nodes which are left with neither prefixes nor children*/
+    while(depth && !new_node.int_bmp && !new_node.ext_bmp){
+
+        node = path[--depth];
+
+        if(!rt_tbm_array_remove(node->children, RT_POPCOUNT64(node->ext_bmp),
+                path_idx[depth], sizeof(rt_tbm_node_t), &new_arr))
+            goto fail;
+
+        /*The emptied node goes away with its parent's old children array*/
+        new_node = *node;
+        new_node.children = new_arr;
+        new_node.ext_bmp &= ~RT_TBM_BIT(path_v[depth]);
+        old[n_old++] = node->children;
+        n_pruned++;
+    }
+
+    if(!rt_tbm_publish(tbm, path, path_idx, depth, &new_node))
+        goto fail;
+
+    for(i = 0; i < n_old; i++)
+        RT_FREE_DEFERRED(old[i]);
+
+    tbm->n_nodes -= n_pruned;
+    tbm->n_prefixes--;
+    return data;
+
+fail:
+    if(n_pruned)
+        RT_FREE(new_node.children);
+    else
+        RT_FREE(new_node.results);
+    return NULL;
+}
+
+void *
+rt_tbm_get(rt_tbm_t *tbm, const uint8_t *key, uint8_t plen){
+
+    rt_tbm_node_t *node = tbm->root;
+    uint32_t pos = 0, v, r;
+
+    if(plen > tbm->key_bits || !node)
+        return NULL;
+
+    while(plen - pos >= RT_TBM_STRIDE){
+
+        v = rt_tbm_chunk(key, tbm->key_bits, pos);
+
+        if(!(node->ext_bmp & RT_TBM_BIT(v)))
+            return NULL;
+
+        node = &node->children[RT_TBM_INDEX(node->ext_bmp, v)];
+        pos += RT_TBM_STRIDE;
+    }
+
+    r = plen - pos;
+    v = rt_tbm_int_pos(r, rt_tbm_chunk(key, tbm->key_bits, pos) >> (RT_TBM_STRIDE - r));
+
+    if(!(node->int_bmp & RT_TBM_BIT(v)))
+        return NULL;
+
+    return node->results[RT_TBM_INDEX(node->int_bmp, v)];
+}
+
+void *
+rt_tbm_lookup(rt_tbm_t *tbm, const uint8_t *addr){
+
+    rt_tbm_node_t *node = RT_DEREF(tbm->root);
+    uint32_t pos = 0, v, p;
+    uint64_t hits;
+    void *best = NULL;
+
+    while(node){
+
+        v = rt_tbm_chunk(addr, tbm->key_bits, pos);
+
+        /*Longer prefixes sit at higher positions, so the highest
+         * matching bit is the longest match inside the node*/
+        hits = node->int_bmp & rt_tbm_int_match_mask(v);
+        if(hits){
+            p = 63 - __builtin_clzll(hits);
+            best = node->results[RT_TBM_INDEX(node->int_bmp, p)];
+        }
+
+        if(!(node->ext_bmp & RT_TBM_BIT(v)))
+            break;
+
+        /*Only the children pointer of a reachable node ever changes*/
+        node = &RT_DEREF(node->children)[RT_TBM_INDEX(node->ext_bmp, v)];
+        pos += RT_TBM_STRIDE;
+
+        if(pos >= tbm->key_bits)
+            break;
+    }
+    return best;
+}
+
+void
+rt_tbm_lookup_batch(rt_tbm_t *tbm, const uint8_t *addrs,
+                    void **results, uint32_t n){
+
+    rt_tbm_node_t *root = RT_DEREF(tbm->root), *node;
+    rt_tbm_node_t *nodes[RT_LOOKUP_GROUP];
+    uint8_t active[RT_LOOKUP_GROUP];
+    uint32_t addr_len = tbm->key_bits / 8;
+    uint32_t base, n_group, n_active, n_next, i, j, v, p, pos;
+    const uint8_t *addr;
+    uint64_t hits;
+
+    for(base = 0; base < n; base += RT_LOOKUP_GROUP){
+
+        n_group = n - base < RT_LOOKUP_GROUP ? n - base : RT_LOOKUP_GROUP;
+
+        for(i = 0; i < n_group; i++){
+            results[base + i] = NULL;
+            nodes[i] = root;
+            active[i] = i;
+        }
+        n_active = root ? n_group : 0;
+
+        /*All the lookups active in a round are at the same depth*/
+        for(pos = 0; n_active && pos < tbm->key_bits; pos += RT_TBM_STRIDE){
+
+            for(j = 0, n_next = 0; j < n_active; j++){
+
+                i = active[j];
+                node = nodes[i];
+                addr = addrs + ((base + i) * addr_len);
+                v = rt_tbm_chunk(addr, tbm->key_bits, pos);
+
+                hits = node->int_bmp & rt_tbm_int_match_mask(v);
+                if(hits){
+                    p = 63 - __builtin_clzll(hits);
+                    results[base + i] = node->results[RT_TBM_INDEX(node->int_bmp, p)];
+                }
+
+                if(!(node->ext_bmp & RT_TBM_BIT(v)))
+                    continue;
+
+                node = &RT_DEREF(node->children)[RT_TBM_INDEX(node->ext_bmp, v)];
+                RT_PREFETCH(node);
+                nodes[i] = node;
+                active[n_next++] = i;
+            }
+            n_active = n_next;
+        }
+    }
+}
+
+uint64_t
+rt_tbm_mem_usage(rt_tbm_t *tbm){
+
+    return sizeof(rt_tbm_t) +
+           ((uint64_t)tbm->n_nodes * sizeof(rt_tbm_node_t)) +
+           ((uint64_t)tbm->n_prefixes * sizeof(void *));
+}
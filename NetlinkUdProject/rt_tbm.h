@@ -0,0 +1,102 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_tbm.h
+ *
+ *    Description:  Tree bitmap multibit trie for IPV4 and IPV6 longest prefix match
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 12:14:51 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_TBM__
+#define __RT_TBM__
+
+#include "rt_common.h"
+
+/* Tree bitmap (Eatherton, Varghese, Dittia) with a stride of 6 bits, so
+ * that both bitmaps of a node fit in a 64 bit word and a child/result is
+ * located with a single popcount, like poptrie does.
+ *
+ * A node consumes 6 bits of the key. Prefixes which end inside a node, i.e.
+ * which have 0 to 5 bits left after the node's depth, are recorded in
+ * int_bmp at position (2^r - 1) + v, r being the number of bits left and
+ * v their value. Bit v of ext_bmp is set if there is a child node for the
+ * 6 bit value v. Children and results are kept in compact arrays in
+ * bitmap order, hence a node is only 32 bytes and two of them share a
+ * cache line.
+ *
+ * Updates are copy on write so that rt_tbm_lookup() may run concurrently
+ * with them (see rt_common.h), the other calls are writer side*/
+
+#define RT_TBM_STRIDE   6
+
+typedef struct rt_tbm_node_{
+
+    uint64_t ext_bmp;
+    uint64_t int_bmp;
+    struct rt_tbm_node_ *children;
+    void **results;
+} rt_tbm_node_t;
+
+typedef struct rt_tbm_{
+
+    rt_tbm_node_t *root;    /*NULL while empty*/
+    uint8_t key_bits;       /*32 for IPV4, 128 for IPV6*/
+    uint32_t n_prefixes;
+    uint32_t n_nodes;
+} rt_tbm_t;
+
+/*Keys are passed as byte arrays in network byte order*/
+
+void
+rt_tbm_init(rt_tbm_t *tbm, uint8_t key_bits);
+
+/*Frees all the nodes, the data is left to the caller*/
+void
+rt_tbm_destroy(rt_tbm_t *tbm);
+
+rt_bool_t
+rt_tbm_insert(rt_tbm_t *tbm, const uint8_t *key, uint8_t plen, void *data);
+
+/*Returns the data of the removed prefix, NULL if not present*/
+void *
+rt_tbm_delete(rt_tbm_t *tbm, const uint8_t *key, uint8_t plen);
+
+void *
+rt_tbm_get(rt_tbm_t *tbm, const uint8_t *key, uint8_t plen);
+
+/*Longest prefix match*/
+void *
+rt_tbm_lookup(rt_tbm_t *tbm, const uint8_t *addr);
+
+/* rt_tbm_lookup() of n addrs packed one after the other, key_bits / 8
+ * bytes each. The cache misses of the lookups overlap*/
+void
+rt_tbm_lookup_batch(rt_tbm_t *tbm, const uint8_t *addrs,
+                    void **results, uint32_t n);
+
+/*Bytes held by the nodes and result arrays*/
+uint64_t
+rt_tbm_mem_usage(rt_tbm_t *tbm);
+
+#endif /* __RT_TBM__ */
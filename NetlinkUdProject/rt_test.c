@@ -0,0 +1,304 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_test.c
+ *
+ *    Description:  This file checks the longest prefix matches of the routing table against a brute force lookup
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:05:12 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+/* Usage : rt_test.exe [rounds] [seed]
+ *
+ * Each round fills a table with random IPV4 routes, nested in a few /8s
+ * so that most addresses match several of them, then for every engine
+ * changes some routes with the engine attached and looks up addresses
+ * at the bounds of each route, and random ones, one by one and in a
+ * batch. The FIB snapshot, as is and ORTC compressed, is checked the
+ * same way. Every result is compared to a linear scan of the routes
+ * the test added. Exits with 1 on the first mismatch*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "rt.h"
+
+#define RT_TEST_MAX_ROUTES  2048
+#define RT_TEST_N_GW        4       /*Few next hops, ORTC has work to do*/
+#define RT_TEST_N_CHANGES   64      /*Per engine*/
+#define RT_TEST_N_RANDOM    4096    /*Random addresses per check*/
+
+typedef struct rt_test_route_{
+
+    uint32_t addr;      /*Host byte order, masked*/
+    uint8_t mask;
+    uint8_t gw;         /*Next hop 10.255.0.gw + 1*/
+} rt_test_route_t;
+
+static rt_table_t rt_table;
+static rt_test_route_t routes[RT_TEST_MAX_ROUTES];
+static uint32_t n_routes;
+static uint32_t addrs[RT_TEST_MAX_ROUTES * 3 + RT_TEST_N_RANDOM];
+static rt_entry_t *results[RT_TEST_MAX_ROUTES * 3 + RT_TEST_N_RANDOM];
+
+static uint32_t
+rt_test_rand(uint64_t *seed){
+
+    *seed = (*seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+    return (uint32_t)(*seed >> 32);
+}
+
+static void
+rt_test_ntop(uint32_t addr, char *buf){
+
+    struct in_addr in;
+
+    in.s_addr = htonl(addr);
+    inet_ntop(AF_INET, &in, buf, RT_IP_ADDR_STRLEN);
+}
+
+/*The route of addr with the longest mask, NULL if none*/
+static rt_test_route_t *
+rt_test_lookup(uint32_t addr){
+
+    rt_test_route_t *best = NULL;
+    uint32_t i;
+
+    for(i = 0; i < n_routes; i++){
+        if((addr & rt_ipv4_mask(routes[i].mask)) == routes[i].addr &&
+            (!best || routes[i].mask > best->mask))
+            best = &routes[i];
+    }
+    return best;
+}
+
+static rt_bool_t
+rt_test_add(uint64_t *seed){
+
+    rt_test_route_t *route = &routes[n_routes];
+    char dest_ip[RT_IP_ADDR_STRLEN], gw_ip[RT_IP_ADDR_STRLEN];
+    uint32_t addr = ((10 + (rt_test_rand(seed) % 4)) << 24) |
+                        (rt_test_rand(seed) & 0xFFFFFF);
+
+    if(n_routes == RT_TEST_MAX_ROUTES)
+        return RT_FALSE;
+
+    /*A default route now and then, the rest spread over all lengths*/
+    route->mask = rt_test_rand(seed) % 64 ? 8 + (rt_test_rand(seed) % 25) : 0;
+    route->addr = addr & rt_ipv4_mask(route->mask);
+    route->gw = rt_test_rand(seed) % RT_TEST_N_GW;
+
+    rt_test_ntop(route->addr, dest_ip);
+    rt_test_ntop((10U << 24) | (255U << 16) | (route->gw + 1U), gw_ip);
+
+    /*Already present*/
+    if(!rt_add_new_rt_entry(&rt_table, dest_ip, route->mask, gw_ip, "lo"))
+        return RT_FALSE;
+
+    n_routes++;
+    return RT_TRUE;
+}
+
+static void
+rt_test_delete(uint64_t *seed){
+
+    rt_test_route_t *route;
+    char dest_ip[RT_IP_ADDR_STRLEN];
+
+    if(!n_routes)
+        return;
+
+    route = &routes[rt_test_rand(seed) % n_routes];
+    rt_test_ntop(route->addr, dest_ip);
+
+    if(!rt_delete_rt_entry(&rt_table, dest_ip, route->mask)){
+        printf("Error : %s/%u could not be deleted\n", dest_ip, route->mask);
+        exit(1);
+    }
+    *route = routes[--n_routes];
+}
+
+/*First and last address of each route, the one past it, random ones*/
+static uint32_t
+rt_test_addrs(uint64_t *seed){
+
+    uint32_t i, n = 0, last;
+
+    for(i = 0; i < n_routes; i++){
+        last = routes[i].addr | ~rt_ipv4_mask(routes[i].mask);
+        addrs[n++] = routes[i].addr;
+        addrs[n++] = last;
+        addrs[n++] = last + 1;
+    }
+
+    for(i = 0; i < RT_TEST_N_RANDOM; i++){
+        addrs[n++] = rt_test_rand(seed) % 2 ?
+            ((10 + (rt_test_rand(seed) % 5)) << 24) | (rt_test_rand(seed) & 0xFFFFFF) :
+            rt_test_rand(seed);
+    }
+    return n;
+}
+
+static void
+rt_test_fail(const char *what, uint32_t addr, rt_test_route_t *expected){
+
+    char addr_ip[RT_IP_ADDR_STRLEN], dest_ip[RT_IP_ADDR_STRLEN];
+
+    rt_test_ntop(addr, addr_ip);
+
+    if(expected){
+        rt_test_ntop(expected->addr, dest_ip);
+        printf("Error : %s of %s, expected %s/%u\n", what, addr_ip,
+            dest_ip, expected->mask);
+    }
+    else
+        printf("Error : %s of %s, expected no route\n", what, addr_ip);
+    exit(1);
+}
+
+static void
+rt_test_check_entry(const char *what, uint32_t addr, rt_entry_t *rt_entry){
+
+    rt_test_route_t *expected = rt_test_lookup(addr);
+    uint32_t dest;
+
+    if(!rt_entry || !expected){
+        if(rt_entry || expected)
+            rt_test_fail(what, addr, expected);
+        return;
+    }
+
+    memcpy(&dest, rt_entry->dest_addr, sizeof(dest));
+    if(ntohl(dest) != expected->addr || rt_entry->mask != expected->mask)
+        rt_test_fail(what, addr, expected);
+}
+
+static void
+rt_test_check_engine(uint64_t *seed){
+
+    uint32_t i, n = rt_test_addrs(seed);
+
+    rt_read_lock();
+
+    for(i = 0; i < n; i++)
+        rt_test_check_entry("rt_lookup_lpm()", addrs[i],
+            rt_lookup_lpm(&rt_table, addrs[i]));
+
+    rt_lookup_batch(&rt_table, addrs, results, n);
+    for(i = 0; i < n; i++)
+        rt_test_check_entry("rt_lookup_batch()", addrs[i], results[i]);
+
+    rt_read_unlock();
+}
+
+/* Checks the snapshot of the table. Compressed, its routes differ from
+ * the table's, only the next hop of each address is to be the same*/
+static void
+rt_test_check_fib(uint64_t *seed, rt_bool_t compressed){
+
+    const char *what = compressed ? "ORTC rt_fib_lookup()" : "rt_fib_lookup()";
+    const rt_fib_result_t *result;
+    rt_test_route_t *expected;
+    uint32_t i, n = rt_test_addrs(seed), dest, gw;
+
+    if(!rt_table_compress_fib(&rt_table, compressed) ||
+        !rt_table_enable_fib(&rt_table, 0)){
+        printf("Error : FIB snapshot compilation failed\n");
+        exit(1);
+    }
+
+    rt_read_lock();
+
+    for(i = 0; i < n; i++){
+
+        result = rt_fib_lookup(rt_table_fib(&rt_table), addrs[i]);
+        expected = rt_test_lookup(addrs[i]);
+
+        if(!result || !expected){
+            if(result || expected)
+                rt_test_fail(what, addrs[i], expected);
+            continue;
+        }
+
+        memcpy(&dest, result->dest_addr, sizeof(dest));
+        memcpy(&gw, result->gw_addr, sizeof(gw));
+
+        if(ntohl(gw) != ((10U << 24) | (255U << 16) | (expected->gw + 1U)) ||
+            (!compressed && (ntohl(dest) != expected->addr ||
+                result->mask != expected->mask)))
+            rt_test_fail(what, addrs[i], expected);
+    }
+
+    rt_read_unlock();
+    rt_table_disable_fib(&rt_table);
+}
+
+int
+main(int argc, char **argv){
+
+    uint32_t rounds = argc > 1 ? atoi(argv[1]) : 20;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 0) : 1;
+    uint32_t round, i, n;
+    rt_engine_t engine;
+
+    for(round = 0; round < rounds; round++){
+
+        rt_init_rt_table(&rt_table);
+        n_routes = 0;
+
+        /*From a handful of routes to a crowded table*/
+        n = 1 + (rt_test_rand(&seed) % (RT_TEST_MAX_ROUTES / 2));
+        for(i = 0; i < n; i++)
+            rt_test_add(&seed);
+
+        for(engine = 0; engine < RT_ENGINE_MAX; engine++){
+
+            if(!rt_table_set_engine(&rt_table, engine, 0) ||
+                rt_table_engine(&rt_table) != engine){
+                printf("Error : engine %s could not be set\n", rt_engine_name(engine));
+                return 1;
+            }
+
+            /*The engine follows the changes*/
+            for(i = 0; i < RT_TEST_N_CHANGES; i++){
+                if(rt_test_rand(&seed) % 2)
+                    rt_test_add(&seed);
+                else
+                    rt_test_delete(&seed);
+            }
+
+            rt_test_check_engine(&seed);
+        }
+
+        rt_test_check_fib(&seed, RT_FALSE);
+        rt_test_check_fib(&seed, RT_TRUE);
+
+        printf("round %u : %u routes, %u engines and the FIB snapshot ok\n",
+            round, n_routes, RT_ENGINE_MAX);
+        rt_free_rt_table(&rt_table);
+    }
+
+    printf("All %u rounds passed\n", rounds);
+    return 0;
+}
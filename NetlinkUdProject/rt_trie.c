@@ -0,0 +1,418 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_trie.c
+ *
+ *    Description:  Implementation of path compressed binary trie for IPV4 longest prefix match
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:21:40 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include "rt_trie.h"
+
+static rt_trie_node_t *
+rt_trie_node_new(rt_trie_t *trie, uint32_t key, uint8_t plen, void *data){
+
+    rt_trie_node_t *node = RT_CALLOC(sizeof(rt_trie_node_t));
+
+    if(!node)
+        return NULL;
+
+    node->key = key & rt_ipv4_mask(plen);
+    node->plen = plen;
+    node->data = data;
+    trie->n_nodes++;
+    return node;
+}
+
+static void
+rt_trie_node_free(rt_trie_t *trie, rt_trie_node_t *node){
+
+    trie->n_nodes--;
+    /*Lookups may still be walking through it*/
+    RT_FREE_DEFERRED(node);
+}
+
+/*Number of leading bits common to a and b, capped at max_len*/
+static inline uint8_t
+rt_trie_common_len(uint32_t a, uint32_t b, uint8_t max_len){
+
+    uint32_t diff = a ^ b;
+    uint8_t len;
+
+    if(!diff)
+        return max_len;
+
+    len = (uint8_t)__builtin_clz(diff);
+    return len < max_len ? len : max_len;
+}
+
+void
+rt_trie_init(rt_trie_t *trie){
+
+    trie->root = NULL;
+    trie->n_prefixes = 0;
+    trie->n_nodes = 0;
+}
+
+rt_bool_t
+rt_trie_insert(rt_trie_t *trie, uint32_t key, uint8_t plen, void *data){
+
+    rt_trie_node_t **slot = &trie->root;
+    rt_trie_node_t *node, *new_node, *glue;
+    uint8_t common;
+
+    if(plen > RT_IPV4_MAX_MASK || !data)
+        return RT_FALSE;
+
+    key &= rt_ipv4_mask(plen);
+
+    while((node = *slot)){
+
+        common = rt_trie_common_len(key, node->key,
+                    plen < node->plen ? plen : node->plen);
+
+        if(common < node->plen){
+
+            /*key/plen is not inside node's subtree, a new node has to
+             * be placed above node*/
+            new_node = rt_trie_node_new(trie, key, plen, data);
+            if(!new_node)
+                return RT_FALSE;
+
+            if(common == plen){
+                /*New prefix covers the node*/
+                new_node->child[rt_ipv4_bit(node->key, plen)] = node;
+                RT_PUBLISH(*slot, new_node);
+                trie->n_prefixes++;
+                return RT_TRUE;
+            }
+
+            /*Both diverge at bit position common, join them under a glue node*/
+            glue = rt_trie_node_new(trie, key, common, NULL);
+            if(!glue){
+                rt_trie_node_free(trie, new_node);
+                return RT_FALSE;
+            }
+            glue->child[rt_ipv4_bit(key, common)] = new_node;
+            glue->child[rt_ipv4_bit(node->key, common)] = node;
+            RT_PUBLISH(*slot, glue);
+            trie->n_prefixes++;
+            return RT_TRUE;
+        }
+
+        if(node->plen == plen){
+            if(node->data)
+                return RT_FALSE;
+            RT_PUBLISH(node->data, data);
+            trie->n_prefixes++;
+            return RT_TRUE;
+        }
+
+        slot = &node->child[rt_ipv4_bit(key, node->plen)];
+    }
+
+    new_node = rt_trie_node_new(trie, key, plen, data);
+    if(!new_node)
+        return RT_FALSE;
+    RT_PUBLISH(*slot, new_node);
+    trie->n_prefixes++;
+    return RT_TRUE;
+}
+
+/*Frees a subtree which no lookup can reach*/
+static void
+rt_trie_free_subtree(rt_trie_t *trie, rt_trie_node_t *node){
+
+    if(!node)
+        return;
+
+    rt_trie_free_subtree(trie, node->child[0]);
+    rt_trie_free_subtree(trie, node->child[1]);
+    trie->n_nodes--;
+    RT_FREE(node);
+}
+
+/*Index of the first prefix with bit pos set, all agree on the bits before*/
+static uint32_t
+rt_trie_build_split(const rt_trie_prefix_t *prefixes, uint32_t n, uint8_t pos){
+
+    uint32_t lo = 0, hi = n, mid;
+
+    while(lo < hi){
+        mid = lo + (hi - lo) / 2;
+        if(rt_ipv4_bit(prefixes[mid].key, pos))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+static rt_trie_node_t *
+rt_trie_build_range(rt_trie_t *trie, const rt_trie_prefix_t *prefixes,
+                    uint32_t n, rt_bool_t *failed){
+
+    const rt_trie_prefix_t *first = prefixes;
+    rt_trie_node_t *child[2], *node;
+    void *data = NULL;
+    uint32_t split = 0;
+    uint8_t plen;
+
+    if(!n || *failed)
+        return NULL;
+
+    /*Sorted, so the first and last prefixes share the fewest bits*/
+    plen = rt_trie_common_len(first->key, prefixes[n - 1].key, first->plen);
+
+    /*Either the first prefix covers the whole range and roots it, or a
+     * glue node splits the range where the keys start to differ*/
+    if(plen == first->plen){
+        data = first->data;
+        prefixes++;
+        n--;
+    }
+
+    if(n)
+        split = rt_trie_build_split(prefixes, n, plen);
+
+    child[0] = rt_trie_build_range(trie, prefixes, split, failed);
+    child[1] = rt_trie_build_range(trie, prefixes + split, n - split, failed);
+
+    node = *failed ? NULL : rt_trie_node_new(trie, first->key, plen, data);
+
+    if(!node){
+        *failed = RT_TRUE;
+        rt_trie_free_subtree(trie, child[0]);
+        rt_trie_free_subtree(trie, child[1]);
+        return NULL;
+    }
+
+    node->child[0] = child[0];
+    node->child[1] = child[1];
+    return node;
+}
+
+rt_bool_t
+rt_trie_build(rt_trie_t *trie, const rt_trie_prefix_t *prefixes, uint32_t n){
+
+    rt_trie_node_t *root;
+    rt_bool_t failed = RT_FALSE;
+
+    if(trie->root)
+        return RT_FALSE;
+
+    root = rt_trie_build_range(trie, prefixes, n, &failed);
+
+    if(failed)
+        return RT_FALSE;
+
+    RT_PUBLISH(trie->root, root);
+    trie->n_prefixes = n;
+    return RT_TRUE;
+}
+
+void
+rt_trie_destroy(rt_trie_t *trie){
+
+    rt_trie_free_subtree(trie, trie->root);
+    rt_trie_init(trie);
+}
+
+void *
+rt_trie_delete(rt_trie_t *trie, uint32_t key, uint8_t plen){
+
+    rt_trie_node_t **slot = &trie->root, 
+                   **parent_slot = NULL;
+    rt_trie_node_t *node, *parent, *child;
+    void *data;
+
+    if(plen > RT_IPV4_MAX_MASK)
+        return NULL;
+
+    key &= rt_ipv4_mask(plen);
+
+    while((node = *slot)){
+
+        if(node->plen > plen ||
+           (key & rt_ipv4_mask(node->plen)) != node->key)
+            return NULL;
+
+        if(node->plen == plen)
+            break;
+
+        parent_slot = slot;
+        slot = &node->child[rt_ipv4_bit(key, node->plen)];
+    }
+
+    if(!node || !node->data)
+        return NULL;
+
+    data = node->data;
+    trie->n_prefixes--;
+
+    if(node->child[0] && node->child[1]){
+        /*Node still differentiates two subtrees, it becomes a glue node*/
+        RT_PUBLISH(node->data, NULL);
+        return data;
+    }
+
+    child = node->child[0] ? node->child[0] : node->child[1];
+    RT_PUBLISH(*slot, child);
+    rt_trie_node_free(trie, node);
+
+    if(child || !parent_slot)
+        return data;
+
+    /*node was a leaf, its parent may have turned into a glue node with
+     * just one child, which must not exist in a path compressed trie*/
+    parent = *parent_slot;
+    if(parent->data)
+        return data;
+
+    RT_PUBLISH(*parent_slot, parent->child[0] ? parent->child[0] : parent->child[1]);
+    rt_trie_node_free(trie, parent);
+    return data;
+}
+
+void *
+rt_trie_get(rt_trie_t *trie, uint32_t key, uint8_t plen){
+
+    rt_trie_node_t *node = trie->root;
+
+    if(plen > RT_IPV4_MAX_MASK)
+        return NULL;
+
+    key &= rt_ipv4_mask(plen);
+
+    while(node){
+
+        if(node->plen > plen ||
+           (key & rt_ipv4_mask(node->plen)) != node->key)
+            return NULL;
+
+        if(node->plen == plen)
+            return node->data;
+
+        node = node->child[rt_ipv4_bit(key, node->plen)];
+    }
+    return NULL;
+}
+
+void *
+rt_trie_get_parent(rt_trie_t *trie, uint32_t key, uint8_t plen,
+                   uint8_t *parent_plen){
+
+    rt_trie_node_t *node = trie->root;
+    void *best = NULL;
+
+    while(node && node->plen < plen){
+
+        if((key & rt_ipv4_mask(node->plen)) != node->key)
+            break;
+
+        if(node->data){
+            best = node->data;
+            *parent_plen = node->plen;
+        }
+
+        node = node->child[rt_ipv4_bit(key, node->plen)];
+    }
+    return best;
+}
+
+void *
+rt_trie_lookup(rt_trie_t *trie, uint32_t addr){
+
+    rt_trie_node_t *node = RT_DEREF(trie->root);
+    void *best = NULL, *data;
+
+    while(node){
+
+        if((addr & rt_ipv4_mask(node->plen)) != node->key)
+            break;
+
+        data = RT_DEREF(node->data);
+        if(data)
+            best = data;
+
+        if(node->plen == RT_IPV4_MAX_MASK)
+            break;
+
+        node = RT_DEREF(node->child[rt_ipv4_bit(addr, node->plen)]);
+    }
+    return best;
+}
+
+void
+rt_trie_lookup_batch(rt_trie_t *trie, const uint32_t *addrs,
+                     void **results, uint32_t n){
+
+    rt_trie_node_t *root = RT_DEREF(trie->root), *node;
+    rt_trie_node_t *nodes[RT_LOOKUP_GROUP];
+    uint8_t active[RT_LOOKUP_GROUP];
+    uint32_t base, n_group, n_active, n_next, i, j, addr;
+    void *data;
+
+    for(base = 0; base < n; base += RT_LOOKUP_GROUP){
+
+        n_group = n - base < RT_LOOKUP_GROUP ? n - base : RT_LOOKUP_GROUP;
+
+        for(i = 0; i < n_group; i++){
+            results[base + i] = NULL;
+            nodes[i] = root;
+            active[i] = i;
+        }
+        n_active = root ? n_group : 0;
+
+        /*Every round moves each lookup still active one node down*/
+        while(n_active){
+
+            for(j = 0, n_next = 0; j < n_active; j++){
+
+                i = active[j];
+                node = nodes[i];
+                addr = addrs[base + i];
+
+                if((addr & rt_ipv4_mask(node->plen)) != node->key)
+                    continue;
+
+                data = RT_DEREF(node->data);
+                if(data)
+                    results[base + i] = data;
+
+                if(node->plen == RT_IPV4_MAX_MASK)
+                    continue;
+
+                node = RT_DEREF(node->child[rt_ipv4_bit(addr, node->plen)]);
+                if(!node)
+                    continue;
+
+                RT_PREFETCH(node);
+                nodes[i] = node;
+                active[n_next++] = i;
+            }
+            n_active = n_next;
+        }
+    }
+}
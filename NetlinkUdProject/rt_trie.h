@@ -0,0 +1,105 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_trie.h
+ *
+ *    Description:  Path compressed binary trie used for IPV4 longest prefix match
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:21:40 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_TRIE__
+#define __RT_TRIE__
+
+#include "rt_common.h"
+
+/* Every node of the trie represents a prefix key/plen. A node carries
+ * data only if the prefix was actually inserted, otherwise it is a
+ * glue node which exists just to hold two subtrees which differ at
+ * bit position plen. Chains of single child nodes are never created,
+ * hence the depth of the trie is bounded by 32 but in practice is
+ * much less than that*/
+typedef struct rt_trie_node_{
+
+    uint32_t key;       /*Prefix bits, host byte order, masked to plen*/
+    uint8_t plen;
+    struct rt_trie_node_ *child[2];
+    void *data;         /*NULL for glue nodes*/
+} rt_trie_node_t;
+
+typedef struct rt_trie_{
+
+    rt_trie_node_t *root;
+    uint32_t n_prefixes;
+    uint32_t n_nodes;
+} rt_trie_t;
+
+typedef struct rt_trie_prefix_{
+
+    uint32_t key;       /*Host byte order, masked to plen*/
+    uint8_t plen;
+    void *data;
+} rt_trie_prefix_t;
+
+void
+rt_trie_init(rt_trie_t *trie);
+
+/*Returns RT_FALSE if key/plen is already present or on alloc failure*/
+rt_bool_t
+rt_trie_insert(rt_trie_t *trie, uint32_t key, uint8_t plen, void *data);
+
+/* Builds the trie bottom up out of n prefixes sorted by key then plen,
+ * without duplicates, in one pass. The trie must be empty, it is
+ * published once complete. On alloc failure the trie is left empty*/
+rt_bool_t
+rt_trie_build(rt_trie_t *trie, const rt_trie_prefix_t *prefixes, uint32_t n);
+
+/*Frees all the nodes at once, no lookup may be running on the trie*/
+void
+rt_trie_destroy(rt_trie_t *trie);
+
+/*Returns the data of the removed prefix, NULL if not present*/
+void *
+rt_trie_delete(rt_trie_t *trie, uint32_t key, uint8_t plen);
+
+/*Exact match*/
+void *
+rt_trie_get(rt_trie_t *trie, uint32_t key, uint8_t plen);
+
+/* Longest prefix strictly shorter than plen which covers key, its
+ * length is returned in parent_plen*/
+void *
+rt_trie_get_parent(rt_trie_t *trie, uint32_t key, uint8_t plen,
+                   uint8_t *parent_plen);
+
+/* Longest prefix match, the only call which may run concurrently with
+ * the writer (see rt_common.h), all others are writer side*/
+void *
+rt_trie_lookup(rt_trie_t *trie, uint32_t addr);
+
+/*rt_trie_lookup() of the n addrs, the cache misses of the lookups overlap*/
+void
+rt_trie_lookup_batch(rt_trie_t *trie, const uint32_t *addrs,
+                     void **results, uint32_t n);
+
+#endif /* __RT_TRIE__ */
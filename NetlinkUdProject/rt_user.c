@@ -29,95 +29,208 @@
  */
 
 #include "rt.h"
+#include "rt_platform.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <arpa/inet.h> /*inet_pton*/
+#include <stdarg.h>
 
-void
-rt_init_rt_table(rt_table_t *rt_table){
+rt_bool_t
+rt_ipv4_pton(char *ip, uint32_t *addr){
 
-    init_glthread(&rt_table->head);
+    uint32_t addr_n;
+
+    if(inet_pton(AF_INET, ip, &addr_n) != 1)
+        return RT_FALSE;
+    *addr = ntohl(addr_n);
+    return RT_TRUE;
 }
 
 rt_bool_t
-rt_add_new_rt_entry(rt_table_t *rt_table,
-    char *dest_ip, char mask, char *gw_ip, char *oif){
+rt_ipv6_pton(char *ip, uint8_t *addr){
+
+    return inet_pton(AF_INET6, ip, addr) == 1 ? RT_TRUE : RT_FALSE;
+}
+
+/*Text form of the gateway of nh, "" if none*/
+void
+rt_gw_ntop(rt_nexthop_t *nh, char *buf, uint32_t buf_len){
+
+    static const uint8_t none[RT_IPV6_ADDR_LEN];
+
+    buf[0] = '\0';
+
+    if(memcmp(nh->gw_addr, none, sizeof(none)))
+        inet_ntop(nh->family, nh->gw_addr, buf, buf_len);
+}
+
+void
+rt_log(const char *fmt, ...){
+
+    va_list args;
+
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+void
+rt_table_lock(rt_table_t *rt_table){
+
+    pthread_mutex_lock(&rt_table->lock);
+    /*What the shared code retires goes to the limbo of the table*/
+    rt_epoch_set_limbo(&rt_table->limbo);
+}
+
+void
+rt_table_unlock(rt_table_t *rt_table){
+
+    rt_epoch_reclaim(&rt_table->limbo);
+    rt_epoch_set_limbo(NULL);
+    pthread_mutex_unlock(&rt_table->lock);
+}
+
+#define RT_PREFIX_HASH_MIN_BUCKETS  16
+
+#define RT_PREFIX_KEY_LEN(family)   \
+    ((family) == AF_INET ? sizeof(uint32_t) : RT_IPV6_ADDR_LEN)
+
+/*FNV-1a followed by a final mix so that the low bits used to pick the
+ * bucket depend on all the key bytes*/
+static inline uint32_t
+rt_prefix_hash_fn(const uint8_t *key, uint32_t key_len){
+
+    uint32_t i, h = 2166136261U;
+
+    for(i = 0; i < key_len; i++){
+        h ^= key[i];
+        h *= 16777619U;
+    }
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    return h;
+}
 
-    rt_entry_t *rt_entry = NULL;
+static rt_bool_t
+rt_prefix_hash_resize(rt_prefix_hash_t *hash, uint32_t n_buckets, uint8_t family){
 
-    rt_entry = calloc(1, sizeof(rt_entry_t));
+    uint32_t i, bucket;
+    rt_entry_t *rt_entry, *next;
+    rt_entry_t **buckets = calloc(n_buckets, sizeof(rt_entry_t *));
 
-    if(!rt_entry)
+    if(!buckets)
         return RT_FALSE;
 
-    strncpy(rt_entry->dest_ip, dest_ip, sizeof(rt_entry->dest_ip));
-    rt_entry->mask = mask;
-    strncpy(rt_entry->gw_ip, gw_ip, sizeof(rt_entry->gw_ip));
-    strncpy(rt_entry->oif, oif, sizeof(rt_entry->oif));
+    for(i = 0; i < hash->n_buckets; i++){
 
-    init_glthread(&rt_entry->rt_entry_glue);
+        for(rt_entry = hash->buckets[i]; rt_entry; rt_entry = next){
 
-    glthread_add_next(&rt_table->head, &rt_entry->rt_entry_glue);
+            next = rt_entry->hash_next;
+            bucket = rt_prefix_hash_fn(rt_entry->dest_addr,
+                        RT_PREFIX_KEY_LEN(family)) & (n_buckets - 1);
+            rt_entry->hash_next = buckets[bucket];
+            buckets[bucket] = rt_entry;
+        }
+    }
+
+    free(hash->buckets);
+    hash->buckets = buckets;
+    hash->n_buckets = n_buckets;
     return RT_TRUE;
 }
 
-rt_bool_t
-rt_delete_rt_entry(rt_table_t *rt_table,
-    char *dest_ip, char mask){
+rt_prefix_hash_t *
+rt_prefix_hash_create(uint8_t family){
 
-    glthread_t *curr;
-    rt_entry_t *rt_entry = NULL;
+    rt_prefix_hash_t *hash = calloc(1, sizeof(rt_prefix_hash_t));
 
-    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
-    
-        rt_entry = rt_entry_glue_to_rt_entry(curr);
+    if(!hash)
+        return NULL;
 
-        if(strncmp(rt_entry->dest_ip, dest_ip, sizeof(rt_entry->dest_ip)) == 0 &&
-            rt_entry->mask == mask){
+    if(!rt_prefix_hash_resize(hash, RT_PREFIX_HASH_MIN_BUCKETS, family)){
+        free(hash);
+        return NULL;
+    }
+    return hash;
+}
 
-            remove_glthread(&rt_entry->rt_entry_glue);
-            free(rt_entry);
-            return RT_TRUE;
-        }
-    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+rt_entry_t *
+rt_prefix_hash_lookup(rt_prefix_hash_t *hash, uint8_t family, uint8_t *addr){
+
+    rt_entry_t *rt_entry;
+    uint32_t key_len = RT_PREFIX_KEY_LEN(family);
 
-    return RT_FALSE;
+    rt_entry = hash->buckets[rt_prefix_hash_fn(addr, key_len) & (hash->n_buckets - 1)];
+
+    for(; rt_entry; rt_entry = rt_entry->hash_next){
+        if(memcmp(rt_entry->dest_addr, addr, key_len) == 0)
+            return rt_entry;
+    }
+    return NULL;
 }
 
 rt_bool_t
-rt_update_rt_entry(rt_table_t *rt_table,
-    char *dest_ip, char mask, 
-    char *new_gw_ip, char *new_oif){
+rt_prefix_hash_insert(rt_prefix_hash_t *hash, rt_entry_t *rt_entry){
+
+    uint32_t bucket;
+
+    if(rt_prefix_hash_lookup(hash, rt_entry->family, rt_entry->dest_addr))
+        return RT_FALSE;
+
+    bucket = rt_prefix_hash_fn(rt_entry->dest_addr,
+                RT_PREFIX_KEY_LEN(rt_entry->family)) & (hash->n_buckets - 1);
+    rt_entry->hash_next = hash->buckets[bucket];
+    hash->buckets[bucket] = rt_entry;
+    hash->n_entries++;
 
+    /*Keep the load factor under 1, a failed resize only costs longer chains*/
+    if(hash->n_entries > hash->n_buckets)
+        rt_prefix_hash_resize(hash, hash->n_buckets * 2, rt_entry->family);
     return RT_TRUE;
 }
 
-void
-rt_clear_rt_table(rt_table_t *rt_table){
+/*Returns the number of entries left in hash*/
+uint32_t
+rt_prefix_hash_remove(rt_prefix_hash_t *hash, rt_entry_t *rt_entry){
 
+    rt_entry_t **pp = &hash->buckets[rt_prefix_hash_fn(rt_entry->dest_addr,
+                        RT_PREFIX_KEY_LEN(rt_entry->family)) & (hash->n_buckets - 1)];
 
-}
+    for(; *pp; pp = &(*pp)->hash_next){
 
-void
-rt_free_rt_table(rt_table_t *rt_table){
+        if(*pp != rt_entry)
+            continue;
 
+        *pp = rt_entry->hash_next;
+        rt_entry->hash_next = NULL;
+        hash->n_entries--;
 
+        if(hash->n_buckets > RT_PREFIX_HASH_MIN_BUCKETS &&
+            hash->n_entries < hash->n_buckets / 8)
+            rt_prefix_hash_resize(hash, hash->n_buckets / 2, rt_entry->family);
+        break;
+    }
+    return hash->n_entries;
 }
 
 void
-rt_dump_rt_table(rt_table_t *rt_table){
+rt_prefix_hash_reserve(rt_prefix_hash_t *hash, uint8_t family, uint32_t n){
+
+    uint32_t n_buckets = hash->n_buckets;
 
-    glthread_t *curr;
-    rt_entry_t *rt_entry = NULL;
+    while(n_buckets < hash->n_entries + n)
+        n_buckets *= 2;
 
-    ITERATE_GLTHREAD_BEGIN(&rt_table->head, curr){
+    /*A failed resize only costs longer chains*/
+    if(n_buckets != hash->n_buckets)
+        rt_prefix_hash_resize(hash, n_buckets, family);
+}
+
+void
+rt_prefix_hash_destroy(rt_prefix_hash_t *hash){
 
-        rt_entry = rt_entry_glue_to_rt_entry(curr);
-    
-        printf("%-20s %-4d %-20s %s\n",
-            rt_entry->dest_ip, 
-            rt_entry->mask, 
-            rt_entry->gw_ip,
-            rt_entry->oif);
-    } ITERATE_GLTHREAD_END(&rt_table->head, curr);
+    free(hash->buckets);
+    free(hash);
 }
@@ -0,0 +1,187 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_vrf.c
+ *
+ *    Description:  Registry of the named routing tables (VRFs) of the kernel module
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:05:12 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#include <linux/xarray.h>
+#include <linux/hashtable.h>
+#include <linux/stringhash.h>
+#include <linux/mutex.h>
+#include "rt_vrf.h"
+
+#define RT_VRF_NAME_HASH_BITS   8
+
+static DEFINE_XARRAY_ALLOC1(rt_vrf_ids);
+static DEFINE_HASHTABLE(rt_vrf_names, RT_VRF_NAME_HASH_BITS);
+static DEFINE_MUTEX(rt_vrf_mutex);
+
+static inline uint32_t
+rt_vrf_name_hash(const char *name){
+
+    return full_name_hash(NULL, name, strnlen(name, RT_VRF_NAME_LEN));
+}
+
+/*Called with rt_vrf_mutex held*/
+static rt_vrf_t *
+rt_vrf_find(const char *name){
+
+    rt_vrf_t *vrf;
+
+    hash_for_each_possible(rt_vrf_names, vrf, name_node, rt_vrf_name_hash(name)){
+        if(strncmp(vrf->name, name, RT_VRF_NAME_LEN) == 0)
+            return vrf;
+    }
+    return NULL;
+}
+
+int
+rt_vrf_create(const char *name, rt_engine_t engine, uint32_t *id){
+
+    int rc;
+    rt_vrf_t *vrf;
+
+    if(!name[0] || (uint32_t)engine >= RT_ENGINE_MAX)
+        return -EINVAL;
+
+    mutex_lock(&rt_vrf_mutex);
+
+    vrf = rt_vrf_find(name);
+
+    if(vrf){
+        *id = vrf->id;
+        mutex_unlock(&rt_vrf_mutex);
+        return -EEXIST;
+    }
+
+    vrf = kzalloc(sizeof(rt_vrf_t), GFP_KERNEL);
+
+    if(!vrf){
+        mutex_unlock(&rt_vrf_mutex);
+        return -ENOMEM;
+    }
+
+    strscpy(vrf->name, name, sizeof(vrf->name));
+    refcount_set(&vrf->ref_count, 1);
+    rt_init_rt_table(&vrf->rt_table);
+
+    /*No routes yet, nothing to build but the engine itself*/
+    if(!rt_table_set_engine(&vrf->rt_table, engine, 0)){
+        mutex_unlock(&rt_vrf_mutex);
+        rt_free_rt_table(&vrf->rt_table);
+        kfree(vrf);
+        return -ENOMEM;
+    }
+
+    /*Lookups by id may find it from now on*/
+    rc = xa_alloc(&rt_vrf_ids, &vrf->id, vrf, xa_limit_31b, GFP_KERNEL);
+
+    if(rc){
+        mutex_unlock(&rt_vrf_mutex);
+        rt_free_rt_table(&vrf->rt_table);
+        kfree(vrf);
+        return rc;
+    }
+
+    hash_add(rt_vrf_names, &vrf->name_node, rt_vrf_name_hash(vrf->name));
+    *id = vrf->id;
+
+    mutex_unlock(&rt_vrf_mutex);
+    return 0;
+}
+
+int
+rt_vrf_delete(uint32_t id){
+
+    rt_vrf_t *vrf;
+
+    mutex_lock(&rt_vrf_mutex);
+
+    vrf = xa_erase(&rt_vrf_ids, id);
+    if(vrf)
+        hash_del(&vrf->name_node);
+
+    mutex_unlock(&rt_vrf_mutex);
+
+    if(!vrf)
+        return -ENOENT;
+
+    rt_vrf_put(vrf);
+    return 0;
+}
+
+rt_vrf_t *
+rt_vrf_get(uint32_t id){
+
+    rt_vrf_t *vrf;
+
+    rcu_read_lock();
+    vrf = xa_load(&rt_vrf_ids, id);
+    /*Being deleted*/
+    if(vrf && !refcount_inc_not_zero(&vrf->ref_count))
+        vrf = NULL;
+    rcu_read_unlock();
+    return vrf;
+}
+
+void
+rt_vrf_put(rt_vrf_t *vrf){
+
+    if(!refcount_dec_and_test(&vrf->ref_count))
+        return;
+
+    rt_free_rt_table(&vrf->rt_table);
+    /*rt_vrf_get() may still be looking at it*/
+    kfree_rcu(vrf, rcu);
+}
+
+uint32_t
+rt_vrf_lookup(const char *name){
+
+    rt_vrf_t *vrf;
+    uint32_t id = 0;
+
+    mutex_lock(&rt_vrf_mutex);
+    vrf = rt_vrf_find(name);
+    if(vrf)
+        id = vrf->id;
+    mutex_unlock(&rt_vrf_mutex);
+    return id;
+}
+
+void
+rt_vrf_destroy_all(void){
+
+    rt_vrf_t *vrf;
+    unsigned long id;
+
+    xa_for_each(&rt_vrf_ids, id, vrf)
+        rt_vrf_delete(id);
+
+    /*The routes of the tables are freed in the background*/
+    rt_reclaim_barrier();
+}
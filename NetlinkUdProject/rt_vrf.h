@@ -0,0 +1,85 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  rt_vrf.h
+ *
+ *    Description:  Registry of the named routing tables (VRFs) of the kernel module
+ *
+ *        Version:  1.0
+ *        Created:  10/17/2026 10:05:12 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Er. Abhishek Sagar, Juniper Networks (https://csepracticals.wixsite.com/csepracticals), sachinites@gmail.com
+ *        Company:  Juniper Networks
+ *
+ *        This file is part of the Netlink Sockets distribution (https://github.com/sachinites) 
+ *        Copyright (c) 2019 Abhishek Sagar.
+ *        This program is free software: you can redistribute it and/or modify it under the terms of the GNU General 
+ *        Public License as published by the Free Software Foundation, version 3.
+ *        
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        visit website : https://csepracticals.wixsite.com/csepracticals for more courses and projects
+ *                                  
+ * =====================================================================================
+ */
+
+#ifndef __RT_VRF__
+#define __RT_VRF__
+
+#include <linux/refcount.h>
+#include <linux/list.h>
+#include "rt.h"
+
+/* Registry of the routing tables of the module. A table is created by
+ * name and gets a compact numeric id, the lowest free one starting at 1,
+ * which the route messages carry. Lookups by id take no lock, they go
+ * through an xarray under RCU, lookups by name through a hash table.
+ * The registry lock only serializes the creations and deletions, each
+ * table has a lock of its own so that programming routes in one table
+ * never waits on another*/
+
+#define RT_VRF_NAME_LEN     32
+
+typedef struct rt_vrf_{
+
+    char name[RT_VRF_NAME_LEN];
+    uint32_t id;
+    /*One held by the registry, one by every rt_vrf_get()*/
+    refcount_t ref_count;
+    struct hlist_node name_node;
+    struct rcu_head rcu;
+    rt_table_t rt_table;
+} rt_vrf_t;
+
+/* Returns 0 and the id of the new table in id, which uses engine, -EEXIST
+ * and the id of the table already named so, or another negative errno*/
+int
+rt_vrf_create(const char *name, rt_engine_t engine, uint32_t *id);
+
+/* Removes the table from the registry, it goes away with the last
+ * reference. -ENOENT if there is no such table*/
+int
+rt_vrf_delete(uint32_t id);
+
+/*Takes a reference on the table of id, NULL if there is none*/
+rt_vrf_t *
+rt_vrf_get(uint32_t id);
+
+/*May sleep, it frees the table with the last reference*/
+void
+rt_vrf_put(rt_vrf_t *vrf);
+
+/*Id of the table named name, 0 if there is none*/
+uint32_t
+rt_vrf_lookup(const char *name);
+
+/*Deletes all the tables, when the module goes away*/
+void
+rt_vrf_destroy_all(void);
+
+#endif /* __RT_VRF__ */
@@ -39,9 +39,18 @@
 #include <memory.h>
 #include <stdint.h>  /*for using uint32_t*/
 #include <pthread.h>
+#include <string.h>
+#include <net/if.h>  /*for IF_NAMESIZE*/
 #undef __KERNEL__
 #include "netLinkKernelUtils.h"
 
+/* Id of the routing table last created, from the NETLINK_TLV_RT_ID of
+ * the reply, what an empty line picks when asked for a table id*/
+static volatile uint32_t last_rt_id;
+
+/*Engines of NETLINK_TLV_RT_ENGINE, an empty line picks the default*/
+#define ENGINE_PROMPT   "Enter engine (0 list, 1 trie, 2 tree bitmap, 3 DIR-24-8, 4 interval) : "
+
 int
 send_netlink_msg_to_kernel(int sock_fd, 
                            char *msg, 
@@ -77,25 +86,30 @@ int nl_add_attr(char *payload,            /*Payload Buffer start ptr*/
 
 
 static void
-nl_create_rt_table(int sock_fd, char *rt_name, int name_len){
+nl_create_rt_table(int sock_fd, char *rt_name, int name_len, uint32_t engine){
 
     /*Create a Payload : 
      * T = 1
      * L = name_len
-     * V = rt_name*/
+     * V = rt_name
+     * followed by the engine TLV*/
    
     int current_tlv_size = 0;
-    char *payload = calloc(1, TLV_OVERHEAD + RTA_ALIGN(name_len));
+    int payload_len = TLV_OVERHEAD + RTA_ALIGN(name_len) + RTA_SPACE(sizeof(engine));
+    char *payload = calloc(1, payload_len);
     /* Alternatively u can alsu use
      * char *payload = calloc(1, RTA_SPACE(name_len));
      * */
     current_tlv_size = nl_add_attr(payload, 
-                                  TLV_OVERHEAD + RTA_ALIGN(name_len),
+                                  payload_len,
                                   current_tlv_size, 
                                   NETLINK_TLV_RT_CREATE, 
                                   name_len, rt_name);
 
     if(current_tlv_size){
+        current_tlv_size += nl_add_attr(payload, payload_len, current_tlv_size,
+                                        NETLINK_TLV_RT_ENGINE,
+                                        sizeof(engine), (char *)&engine);
         send_netlink_msg_to_kernel(sock_fd, payload, current_tlv_size,
             NLMSG_RT_NEW_CREATE, NLM_F_ACK | NLM_F_REQUEST | NLM_F_CREATE);
     }
@@ -103,16 +117,110 @@ nl_create_rt_table(int sock_fd, char *rt_name, int name_len){
     free(payload);
 }
 
+static void
+nl_delete_rt_table(int sock_fd, uint32_t rt_id){
+
+    char payload[RTA_SPACE(sizeof(uint32_t))];
+    int current_tlv_size;
+
+    memset(payload, 0, sizeof(payload));
+    current_tlv_size = nl_add_attr(payload, sizeof(payload), 0,
+                                   NETLINK_TLV_RT_ID,
+                                   sizeof(rt_id), (char *)&rt_id);
+
+    if(current_tlv_size){
+        send_netlink_msg_to_kernel(sock_fd, payload, current_tlv_size,
+            NLMSG_RT_DELETE, NLM_F_ACK | NLM_F_REQUEST);
+    }
+}
+
+static void
+nl_set_rt_table_engine(int sock_fd, uint32_t rt_id, uint32_t engine){
+
+    char payload[2 * RTA_SPACE(sizeof(uint32_t))];
+    int current_tlv_size = 0;
+
+    memset(payload, 0, sizeof(payload));
+    current_tlv_size += nl_add_attr(payload, sizeof(payload), current_tlv_size,
+                                    NETLINK_TLV_RT_ID, sizeof(rt_id), (char *)&rt_id);
+    current_tlv_size += nl_add_attr(payload, sizeof(payload), current_tlv_size,
+                                    NETLINK_TLV_RT_ENGINE, sizeof(engine), (char *)&engine);
+
+    send_netlink_msg_to_kernel(sock_fd, payload, current_tlv_size,
+        NLMSG_RT_SET_ENGINE, NLM_F_ACK | NLM_F_REQUEST);
+}
+
+/*Route msgs carry the id of the routing table and the route as TLVs,
+ *gw and oif may be empty strings when deleting*/
+static void
+nl_route_msg(int sock_fd, int nlmsg_type, uint32_t rt_id,
+             char *dest, uint32_t mask, char *gw, char *oif){
+
+    char payload[MAX_PAYLOAD];
+    int current_tlv_size = 0;
+
+    memset(payload, 0, sizeof(payload));
+
+    current_tlv_size += nl_add_attr(payload, sizeof(payload), current_tlv_size,
+                                    NETLINK_TLV_RT_ID, sizeof(rt_id), (char *)&rt_id);
+    current_tlv_size += nl_add_attr(payload, sizeof(payload), current_tlv_size,
+                                    NETLINK_TLV_RT_DEST, strlen(dest) + 1, dest);
+    current_tlv_size += nl_add_attr(payload, sizeof(payload), current_tlv_size,
+                                    NETLINK_TLV_RT_MASK, sizeof(mask), (char *)&mask);
+    current_tlv_size += nl_add_attr(payload, sizeof(payload), current_tlv_size,
+                                    NETLINK_TLV_RT_GW, strlen(gw) + 1, gw);
+    current_tlv_size += nl_add_attr(payload, sizeof(payload), current_tlv_size,
+                                    NETLINK_TLV_RT_OIF, strlen(oif) + 1, oif);
+
+    send_netlink_msg_to_kernel(sock_fd, payload, current_tlv_size,
+        nlmsg_type, NLM_F_ACK | NLM_F_REQUEST);
+}
+
+/*Reads a line from stdin without the trailing newline*/
+static void
+read_line(const char *prompt, char *buf, int buf_len){
+
+    printf("%s", prompt);
+    memset(buf, 0, buf_len);
 
+    if(fgets(buf, buf_len, stdin) == NULL){
+        printf("error in reading from stdin\n");
+        exit(EXIT_FAILURE);
+    }
+    buf[strcspn(buf, "\n")] = '\0';
+}
 
+static uint32_t
+read_rt_id(void){
 
+    char line[RT_NAME_LEN], prompt[64];
 
+    snprintf(prompt, sizeof(prompt), "Enter routing table id [%u] : ", last_rt_id);
+    read_line(prompt, line, sizeof(line));
+    return line[0] ? strtoul(line, NULL, 10) : last_rt_id;
+}
 
+static void
+read_route(int sock_fd, int nlmsg_type){
 
+    char line[RT_NAME_LEN];
+    char dest[64], gw[64], oif[IF_NAMESIZE];
+    uint32_t rt_id, mask;
 
+    rt_id = read_rt_id();
+    read_line("Enter destination : ", dest, sizeof(dest));
+    read_line("Enter mask : ", line, sizeof(line));
+    mask = strtoul(line, NULL, 10);
 
+    gw[0] = oif[0] = '\0';
 
+    if(nlmsg_type != NLMSG_RT_ROUTE_DELETE){
+        read_line("Enter gateway : ", gw, sizeof(gw));
+        read_line("Enter outgoing interface : ", oif, sizeof(oif));
+    }
 
+    nl_route_msg(sock_fd, nlmsg_type, rt_id, dest, mask, gw, oif);
+}
 
 uint32_t new_seq_no(){
 
@@ -166,7 +274,7 @@ send_netlink_msg_to_kernel(int sock_fd,
      /* Copy the application data to Netlink payload space.
       * Use macro NLMSG_DATA to get ptr to netlink payload data
       * space*/
-     strncpy(NLMSG_DATA(nlh), msg, msg_size);
+     memcpy(NLMSG_DATA(nlh), msg, msg_size);
     
      /*Now, wrap the data to be send inside iovec*/
      /* iovector - It is a conatiner of netlink msg*/
@@ -220,9 +328,11 @@ typedef struct thread_arg_{
 static void *
 _start_kernel_data_receiver_thread(void *arg){
 
-    int rc = 0;
+    int rc = 0, tlvs_len;
+    uint32_t rt_id;
     struct iovec iov;
     struct nlmsghdr *nlh_recv = NULL;
+    struct rtattr *tlv;
     static struct msghdr outermsghdr;
     int sock_fd = 0;
 
@@ -266,6 +376,17 @@ _start_kernel_data_receiver_thread(void *arg){
 
         printf("Received Netlink msg from kernel, bytes recvd = %d\n", rc);
         printf("msg recvd from kernel = %s\n", payload);
+
+        /*The TLVs after the text*/
+        tlvs_len = (int)nlh_recv->nlmsg_len - NLMSG_HDRLEN - NETLINK_REPLY_TEXT_LEN;
+
+        if(rc > 0 && tlvs_len > 0 &&
+           (tlv = TLV_FIND(payload + NETLINK_REPLY_TEXT_LEN, tlvs_len, NETLINK_TLV_RT_ID)) &&
+           RTA_PAYLOAD(tlv) >= sizeof(uint32_t)){
+            memcpy(&rt_id, RTA_DATA(tlv), sizeof(rt_id));
+            last_rt_id = rt_id;
+            printf("routing table id = %u\n", rt_id);
+        }
     } while(1);
 }
 
@@ -343,7 +464,12 @@ main(int argc, char **argv){
         printf("Main-Menu\n");
         printf("\t1. Greet Kernel\n");
         printf("\t2. Create New Routing Table\n");
-        printf("\t3. Exit\n");
+        printf("\t3. Delete Routing Table\n");
+        printf("\t4. Add Route\n");
+        printf("\t5. Delete Route\n");
+        printf("\t6. Update Route\n");
+        printf("\t7. Change Engine of Routing Table\n");
+        printf("\t8. Exit\n");
         printf("choice ? ");
         scanf("%d\n", &choice);
 
@@ -362,18 +488,36 @@ main(int argc, char **argv){
             break;
             case 2:
                 {
-                    printf("Enter name of new Routing Table : ");
-                    char rt_name[32];
-                    memset(rt_name, 0, RT_NAME_LEN);
-                    if((fgets((char *)rt_name, RT_NAME_LEN, stdin) == NULL)){
-                        printf("error in reading from stdin\n");
-                        exit(EXIT_FAILURE);
-                    }
-                    nl_create_rt_table(sock_fd, rt_name, RT_NAME_LEN);
+                    char rt_name[RT_NAME_LEN], line[RT_NAME_LEN];
+                    read_line("Enter name of new Routing Table : ", rt_name, RT_NAME_LEN);
+                    read_line(ENGINE_PROMPT, line, sizeof(line));
+                    nl_create_rt_table(sock_fd, rt_name, strlen(rt_name) + 1,
+                        strtoul(line, NULL, 10));
                 }
             break;
             case 3:
+                nl_delete_rt_table(sock_fd, read_rt_id());
+            break;
+            case 4:
+                read_route(sock_fd, NLMSG_RT_ROUTE_ADD);
+            break;
+            case 5:
+                read_route(sock_fd, NLMSG_RT_ROUTE_DELETE);
+            break;
+            case 6:
+                read_route(sock_fd, NLMSG_RT_ROUTE_UPDATE);
+            break;
+            case 7:
+                {
+                    char line[RT_NAME_LEN];
+                    uint32_t rt_id = read_rt_id();
+                    read_line(ENGINE_PROMPT, line, sizeof(line));
+                    nl_set_rt_table_engine(sock_fd, rt_id, strtoul(line, NULL, 10));
+                }
+            break;
+            case 8:
                 exit_userspace(sock_fd);
+                exit(EXIT_SUCCESS);
             break;
             default:
                 ;